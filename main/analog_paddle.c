@@ -0,0 +1,237 @@
+#include "analog_paddle.h"
+
+#include "esp_adc/adc_continuous.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+#include <math.h>
+
+#define TAG "analog"
+
+#define ADC_CHANNEL CONFIG_PONG_ANALOG_ADC_CHANNEL
+#define ADC_SAMPLE_HZ (20 * 1000)
+#define ADC_RAW_MAX 4095.0f
+
+// 32 samples per DMA frame: one frame every 1.6 ms at 20 kHz. Averaging a
+// frame is our oversampling step (the ESP32 ADC has no hardware filter).
+#define FRAME_SAMPLES 32
+#define FRAME_BYTES (FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES)
+#define FRAME_US (FRAME_SAMPLES * 1000000LL / ADC_SAMPLE_HZ)
+// The pool holds 25.6 ms, more than one game frame between two reads. If
+// the loop stalls longer, the driver flushes the oldest frames instead of
+// dropping the newest.
+#define POOL_FRAMES 16
+// Frames drained per adc_continuous_read() call.
+#define READ_FRAMES 4
+// Completion times of the last DONE_RING frames, indexed by frame number.
+#define DONE_RING 64
+
+// One-euro filter tuning: heavy smoothing while the knob rests, little lag
+// once it moves quickly.
+#define EURO_MIN_CUTOFF_HZ 1.0f
+#define EURO_BETA 0.5f
+#define EURO_D_CUTOFF_HZ 1.0f
+
+#define STATS_PERIOD_US (5 * 1000 * 1000)
+
+typedef struct {
+    bool primed;
+    float x;
+    float dx;
+    int64_t last_us;
+} one_euro_t;
+
+static adc_continuous_handle_t s_adc = NULL;
+// Written by the ADC ISR: frames completed, frames the driver flushed from a
+// full pool, and when each frame completed. Frames reach the pool in order
+// and flushes remove the oldest, so the next frame read is frame number
+// s_frames_read + s_frames_flushed.
+static volatile uint32_t s_frames_done;
+static volatile uint32_t s_frames_flushed;
+static volatile int64_t s_done_us[DONE_RING];
+static uint32_t s_frames_read;
+static one_euro_t s_filter;
+static float s_position = 0.0f;
+static bool s_valid = false;
+
+// Noise floor (Welford on frame averages) and sample-to-output latency.
+static uint32_t s_stat_n;
+static float s_stat_mean;
+static float s_stat_m2;
+static int64_t s_latency_sum;
+static int64_t s_stats_since;
+
+static bool IRAM_ATTR on_conv_done(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *user_data)
+{
+    s_done_us[s_frames_done % DONE_RING] = esp_timer_get_time();
+    s_frames_done++;
+    return false;
+}
+
+static bool IRAM_ATTR on_pool_ovf(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *user_data)
+{
+    s_frames_flushed++;
+    return false;
+}
+
+// When the next frame to be read completed; its samples are centred half a
+// frame before that.
+static int64_t next_frame_sampled_at(int64_t now)
+{
+    uint32_t frame = s_frames_read + s_frames_flushed;
+    if (s_frames_done - frame - 1 >= DONE_RING) {
+        // Not completed yet or already overwritten: only a partial frame or
+        // a burst of flushes gets here.
+        return now - FRAME_US / 2;
+    }
+    return s_done_us[frame % DONE_RING] - FRAME_US / 2;
+}
+
+static float euro_alpha(float cutoff_hz, float dt)
+{
+    float tau = 1.0f / (2.0f * (float)M_PI * cutoff_hz);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+static float one_euro_update(one_euro_t *f, float value, int64_t now_us)
+{
+    if (!f->primed) {
+        f->primed = true;
+        f->x = value;
+        f->dx = 0.0f;
+        f->last_us = now_us;
+        return value;
+    }
+    float dt = (float)(now_us - f->last_us) * 1e-6f;
+    if (dt <= 0.0f) {
+        dt = (float)FRAME_US * 1e-6f;
+    }
+    f->last_us = now_us;
+
+    float a_d = euro_alpha(EURO_D_CUTOFF_HZ, dt);
+    f->dx += a_d * ((value - f->x) / dt - f->dx);
+    float cutoff = EURO_MIN_CUTOFF_HZ + EURO_BETA * fabsf(f->dx);
+    f->x += euro_alpha(cutoff, dt) * (value - f->x);
+    return f->x;
+}
+
+static void stats_update(float frame_avg, int64_t latency_us, int64_t now)
+{
+    s_stat_n++;
+    float delta = frame_avg - s_stat_mean;
+    s_stat_mean += delta / (float)s_stat_n;
+    s_stat_m2 += delta * (frame_avg - s_stat_mean);
+    s_latency_sum += latency_us;
+
+    if (now - s_stats_since < STATS_PERIOD_US) {
+        return;
+    }
+    // The noise figure is only meaningful while the knob is not being turned.
+    float rms = sqrtf(s_stat_m2 / (float)s_stat_n);
+    ESP_LOGI(TAG, "Noise %.2f LSB rms over %lu frames, sample-to-output latency %lld us",
+             rms, (unsigned long)s_stat_n, (long long)(s_latency_sum / s_stat_n));
+    s_stat_n = 0;
+    s_stat_mean = 0.0f;
+    s_stat_m2 = 0.0f;
+    s_latency_sum = 0;
+    s_stats_since = now;
+}
+
+esp_err_t analog_paddle_start(void)
+{
+    adc_continuous_handle_cfg_t handle_cfg = {
+        .max_store_buf_size = FRAME_BYTES * POOL_FRAMES,
+        .conv_frame_size = FRAME_BYTES,
+        .flags.flush_pool = true,
+    };
+    esp_err_t err = adc_continuous_new_handle(&handle_cfg, &s_adc);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    adc_digi_pattern_config_t pattern = {
+        .atten = ADC_ATTEN_DB_12,
+        .channel = ADC_CHANNEL,
+        .unit = ADC_UNIT_1,
+        .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+    };
+    adc_continuous_config_t config = {
+        .pattern_num = 1,
+        .adc_pattern = &pattern,
+        .sample_freq_hz = ADC_SAMPLE_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    };
+    err = adc_continuous_config(s_adc, &config);
+    if (err == ESP_OK) {
+        adc_continuous_evt_cbs_t cbs = {
+            .on_conv_done = on_conv_done,
+            .on_pool_ovf = on_pool_ovf,
+        };
+        err = adc_continuous_register_event_callbacks(s_adc, &cbs, NULL);
+    }
+    if (err == ESP_OK) {
+        s_stats_since = esp_timer_get_time();
+        err = adc_continuous_start(s_adc);
+    }
+    if (err != ESP_OK) {
+        adc_continuous_deinit(s_adc);
+        s_adc = NULL;
+        return err;
+    }
+    ESP_LOGI(TAG, "Analog paddle on ADC1 channel %d, %d Hz, %d samples/frame",
+             ADC_CHANNEL, ADC_SAMPLE_HZ, FRAME_SAMPLES);
+    return ESP_OK;
+}
+
+bool analog_paddle_read(int range, int *pos)
+{
+    if (!s_adc) {
+        return false;
+    }
+
+    static uint8_t buf[FRAME_BYTES * READ_FRAMES];
+    uint32_t len = 0;
+    while (adc_continuous_read(s_adc, buf, sizeof(buf), &len, 0) == ESP_OK && len > 0) {
+        int64_t now = esp_timer_get_time();
+        int frames = (int)((len + FRAME_BYTES - 1) / FRAME_BYTES);
+        for (int f = 0; f < frames; ++f) {
+            int64_t sampled_at = next_frame_sampled_at(now);
+            s_frames_read++;
+            uint32_t sum = 0;
+            uint32_t count = 0;
+            uint32_t end = (uint32_t)(f + 1) * FRAME_BYTES < len ? (uint32_t)(f + 1) * FRAME_BYTES : len;
+            for (uint32_t i = (uint32_t)f * FRAME_BYTES; i + SOC_ADC_DIGI_RESULT_BYTES <= end; i += SOC_ADC_DIGI_RESULT_BYTES) {
+                const adc_digi_output_data_t *out = (const adc_digi_output_data_t *)&buf[i];
+                if (out->type1.channel != ADC_CHANNEL) {
+                    continue;
+                }
+                sum += out->type1.data;
+                count++;
+            }
+            if (count == 0) {
+                continue;
+            }
+
+            float avg = (float)sum / (float)count;
+            s_position = one_euro_update(&s_filter, avg / ADC_RAW_MAX, sampled_at);
+            s_valid = true;
+            stats_update(avg, now - sampled_at, now);
+        }
+    }
+
+    if (!s_valid) {
+        return false;
+    }
+    float p = s_position;
+    if (p < 0.0f) {
+        p = 0.0f;
+    }
+    if (p > 1.0f) {
+        p = 1.0f;
+    }
+    *pos = (int)(p * (float)range + 0.5f);
+    return true;
+}
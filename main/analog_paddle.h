@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+// Potentiometer on an ADC1 pin, sampled by the ADC's DMA engine in continuous
+// mode. The CPU only sees one callback per conversion frame, never per sample.
+esp_err_t analog_paddle_start(void);
+
+// Drains finished DMA frames and runs them through the filter. Writes the
+// filtered position scaled to 0..range; returns false until data arrives.
+bool analog_paddle_read(int range, int *pos);
@@ -0,0 +1,31 @@
+#include "arena.h"
+
+#include <string.h>
+
+void arena_init(arena_t *arena, void *buffer, size_t size)
+{
+    arena->base = buffer;
+    arena->size = size;
+    arena->used = 0;
+    arena->peak = 0;
+}
+
+void *arena_alloc(arena_t *arena, size_t size)
+{
+    size_t start = (arena->used + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (start > arena->size || size > arena->size - start) {
+        return NULL;
+    }
+    void *ptr = arena->base + start;
+    arena->used = start + size;
+    if (arena->used > arena->peak) {
+        arena->peak = arena->used;
+    }
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void arena_reset(arena_t *arena)
+{
+    arena->used = 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bump allocator over a fixed buffer. Everything allocated from it is
+// released at once by arena_reset(); there is no per-object free.
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t used;
+    size_t peak;
+} arena_t;
+
+#define ARENA_ALIGN 8
+
+void arena_init(arena_t *arena, void *buffer, size_t size);
+
+// Returns zeroed memory, or NULL when the arena is full.
+void *arena_alloc(arena_t *arena, size_t size);
+
+void arena_reset(arena_t *arena);
@@ -0,0 +1,149 @@
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_console.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+#include "wake.h"
+
+#define TAG "bench"
+
+#ifdef CONFIG_PONG_STATIC_MEMORY
+#define ENABLE_STATIC_MEMORY 1
+#else
+#define ENABLE_STATIC_MEMORY 0
+#endif
+
+#define NVS_KEY "bench_base"
+
+#define BENCH_WAIT_MS 60000
+
+typedef enum {
+    BENCH_RUN,
+    BENCH_SAVE,
+    BENCH_COMPARE,
+} bench_mode_t;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_pending;
+static bench_mode_t s_mode;
+static int s_status;
+static SemaphoreHandle_t s_done;
+
+static bool baseline_load(bench_baseline_t *baseline)
+{
+    nvs_handle_t handle;
+    if (nvs_open("pong", NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    size_t len = sizeof(*baseline);
+    esp_err_t err = nvs_get_blob(handle, NVS_KEY, baseline, &len);
+    nvs_close(handle);
+    return err == ESP_OK && len == sizeof(*baseline);
+}
+
+static esp_err_t baseline_save(const bench_baseline_t *baseline)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open("pong", NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_blob(handle, NVS_KEY, baseline, sizeof(*baseline));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
+
+static int bench_run(bench_scene_fn start_screen, bench_mode_t mode)
+{
+    bench_baseline_t baseline;
+    bool have_baseline = mode == BENCH_COMPARE && baseline_load(&baseline);
+    if (mode == BENCH_COMPARE && !have_baseline) {
+        printf("{\"error\":\"no baseline stored, run 'bench save' first\"}\n");
+        return 1;
+    }
+
+    bench_baseline_t current;
+    int regressions = bench_suite_run(start_screen, have_baseline ? &baseline : NULL, &current);
+
+    if (mode == BENCH_SAVE) {
+        esp_err_t err = baseline_save(&current);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Saving baseline failed: %s", esp_err_to_name(err));
+            return 1;
+        }
+        ESP_LOGI(TAG, "Baseline saved");
+    }
+    return regressions ? 2 : 0;
+}
+
+bool bench_poll(bench_scene_fn start_screen)
+{
+    portENTER_CRITICAL(&s_lock);
+    bool pending = s_pending;
+    bench_mode_t mode = s_mode;
+    s_pending = false;
+    portEXIT_CRITICAL(&s_lock);
+    if (!pending) {
+        return false;
+    }
+
+    s_status = bench_run(start_screen, mode);
+    xSemaphoreGive(s_done);
+    return true;
+}
+
+static int cmd_bench(int argc, char **argv)
+{
+    bench_mode_t mode = BENCH_RUN;
+    if (argc == 2 && strcmp(argv[1], "save") == 0) {
+        mode = BENCH_SAVE;
+    } else if (argc == 2 && strcmp(argv[1], "compare") == 0) {
+        mode = BENCH_COMPARE;
+    } else if (argc != 1) {
+        printf("usage: bench [save|compare]\n");
+        return 1;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_mode = mode;
+    s_pending = true;
+    portEXIT_CRITICAL(&s_lock);
+    wake_post(WAKE_CONSOLE);
+    if (xSemaphoreTake(s_done, pdMS_TO_TICKS(BENCH_WAIT_MS)) != pdTRUE) {
+        portENTER_CRITICAL(&s_lock);
+        s_pending = false;
+        portEXIT_CRITICAL(&s_lock);
+        printf("benchmark did not finish\n");
+        return 1;
+    }
+    return s_status;
+}
+
+esp_err_t bench_register_command(void)
+{
+#if ENABLE_STATIC_MEMORY
+    static StaticSemaphore_t done_mem;
+    s_done = xSemaphoreCreateBinaryStatic(&done_mem);
+#else
+    s_done = xSemaphoreCreateBinary();
+#endif
+    if (!s_done) {
+        return ESP_ERR_NO_MEM;
+    }
+    static const esp_console_cmd_t command = {
+        .command = "bench",
+        .help = "Run the benchmark scenarios and print JSON; 'save' stores the result as "
+                "baseline, 'compare' flags regressions against it",
+        .hint = "[save|compare]",
+        .func = cmd_bench,
+    };
+    return esp_console_cmd_register(&command);
+}
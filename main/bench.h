@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "bench_suite.h"
+#include "esp_err.h"
+
+// Registers the "bench [save|compare]" console command. The command only
+// queues a request; the game loop runs it from bench_poll(), so the
+// scenarios never race a frame being drawn.
+esp_err_t bench_register_command(void);
+
+// Runs a queued benchmark request, if any, and prints its JSON report.
+// Called by the game loop at a frame boundary; returns true when a run
+// took place, so the caller can resynchronise its frame clock.
+bool bench_poll(bench_scene_fn start_screen);
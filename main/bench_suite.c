@@ -0,0 +1,209 @@
+#include "bench_suite.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "display.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "game.h"
+#include "game_config.h"
+
+// Each scenario doubles its iteration count until one run takes this long.
+#define BENCH_MIN_RUN_US (200 * 1000)
+#define BENCH_MAX_ITERATIONS (1 << 20)
+// Scenarios this much slower than the baseline count as regressions.
+#define BENCH_REGRESSION_PCT 10
+
+// Every drawing scenario is one complete frame, clear to flush, with the
+// panel replaced by the null sink, so numbers cover the render path for
+// both the framebuffer and the strip renderer. bytes/op is what the frame
+// would have sent to the panel. The sprite layer and the strip renderer
+// skip what did not change, so the full-frame scenarios invalidate first.
+// 1024 balls exceed the draw list: the sprite layer then draws the frame
+// directly, strip rendering drops the excess calls, and the report lists
+// them as dropped/op.
+typedef struct {
+    const char *name;
+    void (*run)(int iterations);
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t ns_per_op;
+    uint32_t bytes_per_op;
+    uint32_t dropped_per_op;
+    int iterations;
+} bench_result_t;
+
+static bench_scene_fn s_start_screen;
+static game_t s_game;
+
+static void bench_clear(int iterations)
+{
+    for (int i = 0; i < iterations; ++i) {
+        display_clear(COLOR_BLACK);
+        display_invalidate();
+        display_flush();
+    }
+}
+
+static void bench_hud_text(int iterations)
+{
+    for (int i = 0; i < iterations; ++i) {
+        display_clear(COLOR_BLACK);
+        draw_text(UI_MARGIN, UI_MARGIN, "HISCORE:1234 H:56", UI_SCALE);
+        draw_text(UI_MARGIN, UI_MARGIN + 18 * UI_SCALE, "R:9000us Q:0 S:1", UI_SCALE);
+        for (int h = 0; h < MAX_LIVES; ++h) {
+            draw_heart(SCREEN_W - (MAX_LIVES - h) * 10 * UI_SCALE, UI_MARGIN, UI_SCALE, h > 0);
+        }
+        display_flush();
+    }
+}
+
+static void bench_start_screen(int iterations)
+{
+    for (int i = 0; i < iterations; ++i) {
+        s_start_screen();
+    }
+}
+
+// Balls spread over the screen, shifted every iteration so that the strip
+// renderer cannot skip unchanged strips.
+static void bench_balls(int iterations, int count)
+{
+    for (int i = 0; i < iterations; ++i) {
+        display_clear(COLOR_BLACK);
+        for (int b = 0; b < count; ++b) {
+            int x = (b * 37 + i) % (SCREEN_W - BALL_SIZE);
+            int y = (b * 23 + i) % (SCREEN_H - BALL_SIZE);
+            display_draw_ball(x, y, COLOR_WHITE);
+        }
+        display_flush();
+    }
+}
+
+static void bench_balls_1(int iterations)
+{
+    bench_balls(iterations, 1);
+}
+
+static void bench_balls_64(int iterations)
+{
+    bench_balls(iterations, 64);
+}
+
+static void bench_balls_1024(int iterations)
+{
+    bench_balls(iterations, 1024);
+}
+
+// A typical in-game frame pushed out in full every time.
+static void bench_flush(int iterations)
+{
+    for (int i = 0; i < iterations; ++i) {
+        display_clear(COLOR_BLACK);
+        draw_text(UI_MARGIN, UI_MARGIN, "H:42", 2 * UI_SCALE);
+        display_draw_rect(SCREEN_W / 3, SCREEN_H - PADDLE_H - 2, PADDLE_W, PADDLE_H, COLOR_WHITE);
+        display_draw_ball(SCREEN_W / 2, SCREEN_H / 2, COLOR_WHITE);
+        display_invalidate();
+        display_flush();
+    }
+}
+
+// Classic Pong with the paddle tracking the ball, restarted when lost.
+static void bench_game_step(int iterations)
+{
+    for (int i = 0; i < iterations; ++i) {
+        s_game.paddle.x = FROM_SUBPX(s_game.ball.x) - s_game.paddle.w / 2;
+        game_step(&s_game);
+        if (game_lives(&s_game) <= 0) {
+            game_reset(&s_game, s_game.rng);
+        }
+    }
+}
+
+static const bench_scenario_t k_scenarios[] = {
+    { "clear", bench_clear },
+    { "hud_text", bench_hud_text },
+    { "start_screen", bench_start_screen },
+    { "balls_1", bench_balls_1 },
+    { "balls_64", bench_balls_64 },
+    { "balls_1024", bench_balls_1024 },
+    { "flush", bench_flush },
+    { "game_step", bench_game_step },
+};
+
+_Static_assert(sizeof(k_scenarios) / sizeof(k_scenarios[0]) == BENCH_SCENARIO_COUNT,
+               "BENCH_SCENARIO_COUNT does not match the scenario table");
+
+static bench_result_t bench_measure(const bench_scenario_t *scenario)
+{
+    bench_result_t result = { 0 };
+    for (int n = 1; n <= BENCH_MAX_ITERATIONS; n *= 2) {
+        uint64_t bytes = display_flushed_bytes();
+        uint64_t dropped = display_dropped_calls();
+        int64_t start = esp_timer_get_time();
+        scenario->run(n);
+        int64_t elapsed = esp_timer_get_time() - start;
+        result.ns_per_op = (uint32_t)(elapsed * 1000 / n);
+        result.bytes_per_op = (uint32_t)((display_flushed_bytes() - bytes) / n);
+        result.dropped_per_op = (uint32_t)((display_dropped_calls() - dropped) / n);
+        result.iterations = n;
+        // Let the idle task run; a full suite takes several seconds.
+        vTaskDelay(1);
+        if (elapsed >= BENCH_MIN_RUN_US) {
+            break;
+        }
+    }
+    return result;
+}
+
+int bench_suite_run(bench_scene_fn start_screen, const bench_baseline_t *baseline, bench_baseline_t *current)
+{
+    s_start_screen = start_screen;
+    game_reset(&s_game, 12345);
+    display_set_null_panel(true);
+
+    // Measure everything first: log lines from the scenarios must not end
+    // up inside the report.
+    bench_result_t results[BENCH_SCENARIO_COUNT] = { 0 };
+    for (int i = 0; i < BENCH_SCENARIO_COUNT; ++i) {
+        if (k_scenarios[i].run != bench_start_screen || start_screen) {
+            results[i] = bench_measure(&k_scenarios[i]);
+        }
+    }
+    display_set_null_panel(false);
+    display_invalidate();
+
+    int regressions = 0;
+    bool first = true;
+    printf("{\"screen\":\"%dx%d\",\"render_rows\":%d,\"results\":[", SCREEN_W, SCREEN_H, RENDER_ROWS);
+    for (int i = 0; i < BENCH_SCENARIO_COUNT; ++i) {
+        const bench_result_t *r = &results[i];
+        current->ns_per_op[i] = r->ns_per_op;
+        if (r->iterations == 0) {
+            continue;
+        }
+        printf("%s\n{\"name\":\"%s\",\"ns_per_op\":%lu,\"bytes_per_op\":%lu,\"dropped_per_op\":%lu,"
+               "\"iterations\":%d",
+               first ? "" : ",", k_scenarios[i].name, (unsigned long)r->ns_per_op,
+               (unsigned long)r->bytes_per_op, (unsigned long)r->dropped_per_op, r->iterations);
+        first = false;
+        if (baseline) {
+            uint32_t base = baseline->ns_per_op[i];
+            int change_pct = base ? (int)(((int64_t)r->ns_per_op - base) * 100 / base) : 0;
+            bool regression = change_pct > BENCH_REGRESSION_PCT;
+            regressions += regression;
+            printf(",\"baseline_ns_per_op\":%lu,\"change_pct\":%d,\"regression\":%s",
+                   (unsigned long)base, change_pct, regression ? "true" : "false");
+        }
+        printf("}");
+    }
+    printf("]");
+    if (baseline) {
+        printf(",\"regressions\":%d", regressions);
+    }
+    printf("}\n");
+    return regressions;
+}
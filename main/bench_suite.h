@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+// Draws one complete start screen, including its flush.
+typedef void (*bench_scene_fn)(void);
+
+#define BENCH_SCENARIO_COUNT 8
+
+// ns/op of every scenario, in suite order: what "bench save" stores.
+typedef struct {
+    uint32_t ns_per_op[BENCH_SCENARIO_COUNT];
+} bench_baseline_t;
+
+// Runs every scenario against the null panel and prints the JSON report,
+// compared with `baseline` unless it is NULL. Without a start_screen that
+// scenario is left out of the report and reads 0 in `current`. Nothing but
+// display.c and game.c is needed, so the host builds it too. Returns the
+// number of regressions.
+int bench_suite_run(bench_scene_fn start_screen, const bench_baseline_t *baseline, bench_baseline_t *current);
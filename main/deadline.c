@@ -0,0 +1,196 @@
+#include "deadline.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "display.h"
+#include "esp_console.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+
+#define TAG "deadline"
+
+#ifdef CONFIG_PONG_DEADLINE_HISTORY
+#define DEADLINE_HISTORY CONFIG_PONG_DEADLINE_HISTORY
+#else
+#define DEADLINE_HISTORY 16
+#endif
+
+typedef struct {
+    uint32_t frame;
+    uint32_t total_us;
+    uint32_t phase_us[DEADLINE_PHASE_COUNT];
+    uint32_t flushed_bytes;
+    uint8_t spi_pending;
+    uint8_t steps;
+    uint8_t events;
+} deadline_frame_t;
+
+// Written by the game loop only.
+static int64_t s_period_us;
+static deadline_frame_t s_ring[DEADLINE_HISTORY];
+static uint32_t s_frame;
+static int64_t s_frame_start_us;
+static int64_t s_mark_us;
+static uint64_t s_flushed_at_start;
+
+// Shared with the console task, guarded by s_lock.
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_misses;
+static bool s_captured;
+static uint32_t s_capture_period_us;
+static deadline_frame_t s_capture[DEADLINE_HISTORY];
+
+void deadline_init(int64_t period_us)
+{
+    s_period_us = period_us;
+    s_frame = 0;
+    memset(s_ring, 0, sizeof(s_ring));
+}
+
+void deadline_set_period(int64_t period_us)
+{
+    s_period_us = period_us;
+}
+
+static deadline_frame_t *current_frame(void)
+{
+    return &s_ring[s_frame % DEADLINE_HISTORY];
+}
+
+void deadline_begin_frame(int steps)
+{
+    s_frame_start_us = esp_timer_get_time();
+    s_mark_us = s_frame_start_us;
+    s_flushed_at_start = display_flushed_bytes();
+
+    deadline_frame_t *f = current_frame();
+    memset(f, 0, sizeof(*f));
+    f->frame = s_frame;
+    f->steps = (uint8_t)(steps > UINT8_MAX ? UINT8_MAX : steps);
+}
+
+void deadline_phase(deadline_phase_t phase)
+{
+    int64_t now = esp_timer_get_time();
+    current_frame()->phase_us[phase] += (uint32_t)(now - s_mark_us);
+    s_mark_us = now;
+}
+
+void deadline_event(uint32_t event)
+{
+    current_frame()->events |= (uint8_t)event;
+}
+
+void deadline_end_frame(void)
+{
+    deadline_frame_t *f = current_frame();
+    f->total_us = (uint32_t)(esp_timer_get_time() - s_frame_start_us);
+    f->flushed_bytes = (uint32_t)(display_flushed_bytes() - s_flushed_at_start);
+    f->spi_pending = (uint8_t)display_pending_transfers();
+    s_frame++;
+
+    if (f->total_us <= s_period_us) {
+        return;
+    }
+
+    // Oldest frame first, the overrunning one last.
+    bool first = false;
+    portENTER_CRITICAL(&s_lock);
+    s_misses++;
+    if (!s_captured) {
+        for (int i = 0; i < DEADLINE_HISTORY; ++i) {
+            s_capture[i] = s_ring[(s_frame + i) % DEADLINE_HISTORY];
+        }
+        s_capture_period_us = (uint32_t)s_period_us;
+        s_captured = true;
+        first = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (first) {
+        ESP_LOGW(TAG, "Frame %lu took %lu us (period %lld us), timings captured",
+                 (unsigned long)f->frame, (unsigned long)f->total_us, (long long)s_period_us);
+    }
+}
+
+uint32_t deadline_misses(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    uint32_t misses = s_misses;
+    portEXIT_CRITICAL(&s_lock);
+    return misses;
+}
+
+static void print_events(uint8_t events)
+{
+    static const char *const names[] = { "nvs", "tuning", "game" };
+    bool any = false;
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        if (events & (1u << i)) {
+            printf("%s%s", any ? "," : "", names[i]);
+            any = true;
+        }
+    }
+    printf("%s\n", any ? "" : "-");
+}
+
+static int cmd_deadline(int argc, char **argv)
+{
+    if (argc == 2 && strcmp(argv[1], "clear") == 0) {
+        portENTER_CRITICAL(&s_lock);
+        s_misses = 0;
+        s_captured = false;
+        portEXIT_CRITICAL(&s_lock);
+        printf("cleared\n");
+        return 0;
+    }
+    if (argc != 1) {
+        printf("usage: deadline [clear]\n");
+        return 1;
+    }
+
+    static deadline_frame_t capture[DEADLINE_HISTORY];
+    portENTER_CRITICAL(&s_lock);
+    uint32_t misses = s_misses;
+    bool captured = s_captured;
+    uint32_t period = s_capture_period_us;
+    memcpy(capture, s_capture, sizeof(capture));
+    portEXIT_CRITICAL(&s_lock);
+
+    printf("misses: %lu\n", (unsigned long)misses);
+    if (!captured) {
+        return 0;
+    }
+    printf("first miss, period %lu us (times in us):\n", (unsigned long)period);
+    printf("%8s %6s %6s %6s %6s %6s %7s %3s %5s events\n",
+           "frame", "total", "input", "sim", "render", "flush", "bytes", "spi", "steps");
+    for (int i = 0; i < DEADLINE_HISTORY; ++i) {
+        const deadline_frame_t *f = &capture[i];
+        if (f->total_us == 0) {
+            continue;
+        }
+        printf("%8lu %6lu %6lu %6lu %6lu %6lu %7lu %3u %5u ", (unsigned long)f->frame,
+               (unsigned long)f->total_us, (unsigned long)f->phase_us[DEADLINE_INPUT],
+               (unsigned long)f->phase_us[DEADLINE_SIM], (unsigned long)f->phase_us[DEADLINE_RENDER],
+               (unsigned long)f->phase_us[DEADLINE_FLUSH], (unsigned long)f->flushed_bytes,
+               f->spi_pending, f->steps);
+        print_events(f->events);
+    }
+    return 0;
+}
+
+esp_err_t deadline_register_command(void)
+{
+    static const esp_console_cmd_t command = {
+        .command = "deadline",
+        .help = "Show the deadline miss count and the frame timings captured at the first miss; "
+                "'clear' resets both",
+        .hint = "[clear]",
+        .func = cmd_deadline,
+    };
+    return esp_console_cmd_register(&command);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Frame deadline monitor. The game loop reports where each frame spends its
+// time; the last DEADLINE_HISTORY frames are kept in a ring. The first frame
+// whose work exceeds the target period freezes a copy of that ring, so the
+// frames leading up to the overrun can be read later with the "deadline"
+// console command. Further misses are counted but do not overwrite the
+// capture until it is cleared.
+
+typedef enum {
+    DEADLINE_INPUT,
+    DEADLINE_SIM,
+    DEADLINE_RENDER,
+    DEADLINE_FLUSH,
+    DEADLINE_PHASE_COUNT
+} deadline_phase_t;
+
+// Things that happened during a frame and may explain a slow one.
+#define DEADLINE_EVENT_NVS_COMMIT  (1u << 0)
+#define DEADLINE_EVENT_TUNING      (1u << 1)
+#define DEADLINE_EVENT_GAME_CHANGE (1u << 2)
+
+void deadline_init(int64_t period_us);
+void deadline_set_period(int64_t period_us);
+
+// Called from the game loop only.
+void deadline_begin_frame(int steps);
+// Charges the time since the previous mark to `phase`.
+void deadline_phase(deadline_phase_t phase);
+void deadline_event(uint32_t event);
+void deadline_end_frame(void);
+
+uint32_t deadline_misses(void);
+
+// Registers "deadline [clear]" on the console.
+esp_err_t deadline_register_command(void);
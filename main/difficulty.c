@@ -0,0 +1,160 @@
+#include "difficulty.h"
+
+#include <stdbool.h>
+
+// Difficulty curves are expanded into lookup tables by the preprocessor, so a
+// paddle hit or serve costs one indexed load instead of float math. Each curve
+// maps a hit count to a progress value 0..256 that scales speed, paddle width
+// and serve angle between their base and final values. Serve angles index the
+// direction table in game.c.
+
+#define DIFFICULTY_STEP_HITS CONFIG_PONG_DIFFICULTY_STEP_HITS
+
+_Static_assert(DIFFICULTY_RAMP_HITS > 0 && DIFFICULTY_RAMP_HITS < DIFFICULTY_TABLE_LEN,
+               "difficulty ramp must plateau inside the table");
+_Static_assert(DIFFICULTY_STEP_HITS > 0, "stepped curve needs a positive step");
+_Static_assert(PADDLE_MIN_W > 0 && PADDLE_MIN_W <= PADDLE_W, "invalid minimum paddle width");
+_Static_assert(PADDLE_W <= UINT8_MAX && BALL_MAX_SPEED <= UINT8_MAX, "table fields are 8 bit");
+
+#define RAMP_CLAMP(h) ((h) < DIFFICULTY_RAMP_HITS ? (h) : DIFFICULTY_RAMP_HITS)
+
+#define PROGRESS_LINEAR(h) (RAMP_CLAMP(h) * 256 / DIFFICULTY_RAMP_HITS)
+#define PROGRESS_EASE_IN(h) \
+    (RAMP_CLAMP(h) * RAMP_CLAMP(h) * 256 / (DIFFICULTY_RAMP_HITS * DIFFICULTY_RAMP_HITS))
+#define PROGRESS_STEPPED(h) \
+    ((RAMP_CLAMP(h) / DIFFICULTY_STEP_HITS) * DIFFICULTY_STEP_HITS * 256 / DIFFICULTY_RAMP_HITS)
+
+#define LERP_SPEED(p) (BALL_BASE_SPEED + (BALL_MAX_SPEED - BALL_BASE_SPEED) * (p) / 256)
+#define LERP_WIDTH(p) (PADDLE_W - (PADDLE_W - PADDLE_MIN_W) * (p) / 256)
+#define LERP_SERVE(p) (SERVE_DIR_BASE + (SERVE_DIR_MAX - SERVE_DIR_BASE) * (p) / 256)
+
+// Serve directions: 36.9 degrees from vertical at first, up to 61.9 degrees.
+#define SERVE_DIR_BASE 1
+#define SERVE_DIR_MAX 3
+
+// The linear curve keeps the classic rules: full-width paddle and a
+// fixed serve angle. The other curves also shrink the paddle and flatten
+// the serve as the rally goes on.
+#define LINEAR_ROW(h) { LERP_SPEED(PROGRESS_LINEAR(h)), PADDLE_W, SERVE_DIR_BASE }
+#define EASE_IN_ROW(h) \
+    { LERP_SPEED(PROGRESS_EASE_IN(h)), LERP_WIDTH(PROGRESS_EASE_IN(h)), LERP_SERVE(PROGRESS_EASE_IN(h)) }
+#define STEPPED_ROW(h) \
+    { LERP_SPEED(PROGRESS_STEPPED(h)), LERP_WIDTH(PROGRESS_STEPPED(h)), LERP_SERVE(PROGRESS_STEPPED(h)) }
+
+#define ROWS4(row, h) row(h), row((h) + 1), row((h) + 2), row((h) + 3)
+#define ROWS16(row, h) ROWS4(row, h), ROWS4(row, (h) + 4), ROWS4(row, (h) + 8), ROWS4(row, (h) + 12)
+#define ROWS64(row, h) ROWS16(row, h), ROWS16(row, (h) + 16), ROWS16(row, (h) + 32), ROWS16(row, (h) + 48)
+#define ROWS128(row) ROWS64(row, 0), ROWS64(row, 64)
+
+_Static_assert(DIFFICULTY_TABLE_LEN == 128, "ROWS128 must match the table length");
+
+static const difficulty_t s_curves[CURVE_COUNT][DIFFICULTY_TABLE_LEN] = {
+    [CURVE_LINEAR] = { ROWS128(LINEAR_ROW) },
+    [CURVE_EASE_IN] = { ROWS128(EASE_IN_ROW) },
+    [CURVE_STEPPED] = { ROWS128(STEPPED_ROW) },
+};
+
+#if defined(CONFIG_PONG_DIFFICULTY_EASE_IN)
+#define DEFAULT_CURVE CURVE_EASE_IN
+#elif defined(CONFIG_PONG_DIFFICULTY_STEPPED)
+#define DEFAULT_CURVE CURVE_STEPPED
+#else
+#define DEFAULT_CURVE CURVE_LINEAR
+#endif
+
+const difficulty_t *g_difficulty_table = s_curves[DEFAULT_CURVE];
+
+static difficulty_curve_t s_curve = DEFAULT_CURVE;
+
+// Runtime-tuned copy of the active curve (see difficulty_tune()).
+static difficulty_t s_tuned[DIFFICULTY_TABLE_LEN];
+static bool s_use_tuned;
+static int s_base_speed = BALL_BASE_SPEED;
+static int s_max_speed = BALL_MAX_SPEED;
+static int s_ramp_hits = DIFFICULTY_RAMP_HITS;
+
+// Same progress functions as the PROGRESS_* macros, with a runtime ramp.
+static int tuned_progress(difficulty_curve_t curve, int hits, int ramp)
+{
+    int h = hits < ramp ? hits : ramp;
+    switch (curve) {
+        case CURVE_EASE_IN:
+            return h * h * 256 / (ramp * ramp);
+        case CURVE_STEPPED:
+            return (h / DIFFICULTY_STEP_HITS) * DIFFICULTY_STEP_HITS * 256 / ramp;
+        case CURVE_LINEAR:
+        default:
+            return h * 256 / ramp;
+    }
+}
+
+static void tuned_build(void)
+{
+    for (int hits = 0; hits < DIFFICULTY_TABLE_LEN; ++hits) {
+        int p = tuned_progress(s_curve, hits, s_ramp_hits);
+        difficulty_t *row = &s_tuned[hits];
+        row->speed = (uint8_t)(s_base_speed + (s_max_speed - s_base_speed) * p / 256);
+        if (s_curve == CURVE_LINEAR) {
+            row->paddle_w = PADDLE_W;
+            row->serve_dir = SERVE_DIR_BASE;
+        } else {
+            row->paddle_w = (uint8_t)LERP_WIDTH(p);
+            row->serve_dir = (uint8_t)LERP_SERVE(p);
+        }
+    }
+}
+
+static void difficulty_select(void)
+{
+    if (s_use_tuned) {
+        tuned_build();
+        g_difficulty_table = s_tuned;
+    } else {
+        g_difficulty_table = s_curves[s_curve];
+    }
+}
+
+void difficulty_set_curve(difficulty_curve_t curve)
+{
+    if (curve < 0 || curve >= CURVE_COUNT) {
+        return;
+    }
+    s_curve = curve;
+    difficulty_select();
+}
+
+difficulty_curve_t difficulty_get_curve(void)
+{
+    return s_curve;
+}
+
+void difficulty_tune(int base_speed, int max_speed, int ramp_hits)
+{
+    if (base_speed < 1 || max_speed < base_speed || max_speed > UINT8_MAX) {
+        return;
+    }
+    // The last table entry must be the plateau.
+    if (ramp_hits < 1 || ramp_hits >= DIFFICULTY_TABLE_LEN) {
+        return;
+    }
+    s_base_speed = base_speed;
+    s_max_speed = max_speed;
+    s_ramp_hits = ramp_hits;
+    s_use_tuned = base_speed != BALL_BASE_SPEED || max_speed != BALL_MAX_SPEED ||
+                  ramp_hits != DIFFICULTY_RAMP_HITS;
+    difficulty_select();
+}
+
+const char *difficulty_curve_name(difficulty_curve_t curve)
+{
+    switch (curve) {
+        case CURVE_LINEAR:
+            return "linear";
+        case CURVE_EASE_IN:
+            return "ease-in";
+        case CURVE_STEPPED:
+            return "stepped";
+        default:
+            return "?";
+    }
+}
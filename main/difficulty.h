@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "game_config.h"
+
+// Hits beyond the end of the table reuse the last entry, which every curve
+// guarantees to be its plateau (see DIFFICULTY_RAMP_HITS).
+#define DIFFICULTY_TABLE_LEN 128
+
+// Hits after which the ramp has reached BALL_MAX_SPEED. Derived from the
+// original ball_speed_for_hits() constants so the linear curve is unchanged.
+#define DIFFICULTY_RAMP_HITS \
+    ((BALL_MAX_SPEED - BALL_BASE_SPEED) * BALL_SPEED_STEP_HITS * 10 / BALL_SPEED_FACTOR)
+
+typedef struct {
+    uint8_t speed;
+    uint8_t paddle_w;
+    uint8_t serve_dir;
+} difficulty_t;
+
+typedef enum {
+    CURVE_LINEAR,
+    CURVE_EASE_IN,
+    CURVE_STEPPED,
+    CURVE_COUNT
+} difficulty_curve_t;
+
+extern const difficulty_t *g_difficulty_table;
+
+void difficulty_set_curve(difficulty_curve_t curve);
+difficulty_curve_t difficulty_get_curve(void);
+const char *difficulty_curve_name(difficulty_curve_t curve);
+
+// Rebuilds the active curve with other speed and ramp constants at runtime.
+// Passing the compiled-in values switches back to the const tables.
+void difficulty_tune(int base_speed, int max_speed, int ramp_hits);
+
+static inline const difficulty_t *difficulty_for_hits(int hits)
+{
+    if (hits >= DIFFICULTY_TABLE_LEN) {
+        hits = DIFFICULTY_TABLE_LEN - 1;
+    }
+    return &g_difficulty_table[hits];
+}
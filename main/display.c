@@ -0,0 +1,1179 @@
+#include "display.h"
+
+#include <string.h>
+
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_vendor.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "font8x8_basic.h"
+#include "font_prop.h"
+#include "game_config.h"
+#include "render_core.h"
+
+#define TAG "display"
+
+#define LCD_HOST SPI2_HOST
+
+#define LCD_OFFSET_X CONFIG_PONG_LCD_OFFSET_X
+#define LCD_OFFSET_Y CONFIG_PONG_LCD_OFFSET_Y
+
+#ifdef CONFIG_PONG_LCD_SWAP_XY
+#define LCD_SWAP_XY true
+#else
+#define LCD_SWAP_XY false
+#endif
+
+#ifdef CONFIG_PONG_LCD_MIRROR_X
+#define LCD_MIRROR_X true
+#else
+#define LCD_MIRROR_X false
+#endif
+
+#ifdef CONFIG_PONG_LCD_MIRROR_Y
+#define LCD_MIRROR_Y true
+#else
+#define LCD_MIRROR_Y false
+#endif
+
+#ifdef CONFIG_PONG_LCD_BGR
+#define LCD_COLOR_SPACE ESP_LCD_COLOR_SPACE_BGR
+#else
+#define LCD_COLOR_SPACE ESP_LCD_COLOR_SPACE_RGB
+#endif
+
+#ifdef CONFIG_PONG_STRIP_RENDER
+#define ENABLE_STRIP_RENDER 1
+#else
+#define ENABLE_STRIP_RENDER 0
+#endif
+
+#ifdef CONFIG_PONG_SPRITE_LAYER
+#define ENABLE_SPRITE_LAYER 1
+#else
+#define ENABLE_SPRITE_LAYER 0
+#endif
+
+#ifdef CONFIG_PONG_STATIC_MEMORY
+#define ENABLE_STATIC_MEMORY 1
+#else
+#define ENABLE_STATIC_MEMORY 0
+#endif
+
+// Both strip rendering and the sprite layer record frames before drawing.
+#define ENABLE_DRAW_LIST (ENABLE_STRIP_RENDER || ENABLE_SPRITE_LAYER)
+
+static esp_lcd_panel_handle_t s_panel = NULL;
+#if !ENABLE_STRIP_RENDER
+static uint16_t *s_framebuffer = NULL;
+#if ENABLE_STATIC_MEMORY
+// Plain internal .bss is DMA-capable (only EXT_RAM_BSS_ATTR data may go to
+// PSRAM); DMA_ATTR's .dram1 would store the zeroes in the image.
+WORD_ALIGNED_ATTR static uint16_t s_framebuffer_mem[SCREEN_W * SCREEN_H];
+#endif
+#endif
+static bool s_null_panel;
+static uint64_t s_flushed_bytes;
+static uint64_t s_dropped_calls;
+
+// Windows go out through a sender task. esp_lcd waits for the pixels already
+// queued before it sends the next CASET/RASET, and that wait belongs in a
+// task of its own rather than in the game loop.
+#define TX_QUEUE_LEN 48
+#define TX_TASK_PRIORITY 5
+#define TX_STACK_SIZE 3072
+
+typedef struct {
+    display_window_t window;
+    display_batch_done_fn done;
+    void *ctx;
+    bool last;
+} tx_item_t;
+
+static QueueHandle_t s_tx_queue;
+static TaskHandle_t s_tx_task;
+// Windows submitted and not yet on the wire, guarded by s_tx_lock.
+static portMUX_TYPE s_tx_lock = portMUX_INITIALIZER_UNLOCKED;
+static int s_tx_pending;
+
+#if ENABLE_STATIC_MEMORY
+static StaticQueue_t s_tx_queue_mem;
+static uint8_t s_tx_queue_storage[TX_QUEUE_LEN * sizeof(tx_item_t)];
+static StaticTask_t s_tx_task_mem;
+static StackType_t s_tx_stack[TX_STACK_SIZE];
+#endif
+
+static bool on_color_sent(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(s_tx_task, &woken);
+    return woken == pdTRUE;
+}
+
+static void tx_pending_add(int count)
+{
+    portENTER_CRITICAL(&s_tx_lock);
+    s_tx_pending += count;
+    portEXIT_CRITICAL(&s_tx_lock);
+}
+
+static void display_tx_task(void *arg)
+{
+    int inflight = 0;
+    tx_item_t item;
+    while (true) {
+        xQueueReceive(s_tx_queue, &item, portMAX_DELAY);
+        const display_window_t *w = &item.window;
+        ESP_ERROR_CHECK(esp_lcd_panel_draw_bitmap(s_panel, w->x, w->y, w->x + w->w, w->y + w->h, w->pixels));
+        inflight++;
+        if (!item.last) {
+            continue;
+        }
+        // Pixel transfers complete in order, one notification each.
+        int sent = inflight;
+        while (inflight > 0) {
+            ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+            inflight--;
+        }
+        tx_pending_add(-sent);
+        if (item.done) {
+            item.done(item.ctx);
+        }
+    }
+}
+
+#if ENABLE_DRAW_LIST
+// A Bricks frame with a full obstacle field and HUD needs about 250 entries.
+#define DRAW_LIST_LEN 384
+
+typedef enum {
+    DRAW_FILL,
+    DRAW_BALL,
+    DRAW_GLYPH,
+} draw_kind_t;
+
+// One recorded draw call; x/y/w/h is the screen area it covers.
+typedef struct {
+    const uint8_t *bitmap;
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    uint16_t color;
+    uint8_t kind;
+    uint8_t rows;
+    uint8_t scale;
+} draw_cmd_t;
+
+static draw_cmd_t s_draw_list[DRAW_LIST_LEN];
+static int s_draw_len;
+static bool s_draw_overflow;
+static uint16_t s_clear_color;
+#endif
+
+#if ENABLE_STRIP_RENDER
+#define STRIP_H RENDER_ROWS
+#define STRIP_COUNT ((SCREEN_H + STRIP_H - 1) / STRIP_H)
+
+// Two strip buffers used in turn. s_strip_free counts buffers whose last
+// transfer has completed; the batch done callback gives it back.
+static uint16_t *s_strips[2];
+static int s_next_strip;
+static SemaphoreHandle_t s_strip_free;
+
+#if ENABLE_STATIC_MEMORY
+// Internal .bss, DMA-capable like s_framebuffer_mem.
+WORD_ALIGNED_ATTR static uint16_t s_strip_mem[2][SCREEN_W * STRIP_H];
+static StaticSemaphore_t s_strip_free_mem;
+#endif
+
+// Hash of the draw calls touching each strip in the last sent frame.
+static uint32_t s_strip_hash[STRIP_COUNT];
+static bool s_strip_hash_valid;
+
+// Strip that display_read_rect() last rendered into s_strips[s_next_strip],
+// or -1 once the draw list has changed.
+static int s_read_strip = -1;
+#else
+// Flushes send straight from the framebuffer, so the next frame may only
+// draw into it once the last batch has gone out; the done callback of that
+// batch gives s_fb_free back.
+static SemaphoreHandle_t s_fb_free;
+// Set while a submitted batch may still be reading s_framebuffer.
+static bool s_fb_busy;
+
+#if ENABLE_STATIC_MEMORY
+static StaticSemaphore_t s_fb_free_mem;
+#endif
+#endif
+
+#if ENABLE_SPRITE_LAYER
+// Calls looked for further ahead in the last frame's list when matching.
+#define MATCH_LOOKAHEAD 8
+// Erased and redrawn areas one frame may touch before it is cheaper, and
+// simpler, to draw the whole frame again.
+#define DAMAGE_LEN 64
+// Windows handed to the sender per display_submit_batch() call.
+#define FLUSH_WINDOWS 16
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+} rect_t;
+
+// One draw call of the frame the framebuffer holds.
+typedef struct {
+    rect_t bounds;
+    uint32_t hash;
+} sprite_t;
+
+// The framebuffer holds s_sprite_color with these calls drawn on top, in
+// order, while s_sprites_valid is set.
+static sprite_t s_sprites[DRAW_LIST_LEN];
+static bool s_sprite_kept[DRAW_LIST_LEN];
+static int s_sprite_count;
+static uint16_t s_sprite_color;
+static bool s_sprites_valid;
+
+// Set once the draw list has been drawn into the framebuffer.
+static bool s_resolved;
+// Set when this frame outgrew the draw list and is drawn immediately.
+static bool s_immediate;
+static bool s_cmd_matched[DRAW_LIST_LEN];
+static rect_t s_damage[DAMAGE_LEN];
+static int s_damage_len;
+// Rows changed since the last flush.
+static bool s_dirty_rows[SCREEN_H];
+#endif
+
+#if ENABLE_STRIP_RENDER
+static void on_strip_sent(void *ctx)
+{
+    xSemaphoreGive(s_strip_free);
+}
+#else
+static void on_fb_sent(void *ctx)
+{
+    xSemaphoreGive(s_fb_free);
+}
+
+// Call before anything writes s_framebuffer, and before submitting from it:
+// with at most one batch in flight, a give always means the last one is out.
+static void fb_wait(void)
+{
+    if (s_fb_busy) {
+        xSemaphoreTake(s_fb_free, portMAX_DELAY);
+        s_fb_busy = false;
+    }
+}
+
+static void fb_submit(const display_window_t *windows, int count, bool last)
+{
+    esp_err_t ret = display_submit_batch(windows, count, last ? on_fb_sent : NULL, NULL);
+    if (last) {
+        s_fb_busy = ret == ESP_OK;
+    }
+}
+#endif
+
+#if ENABLE_DRAW_LIST
+
+static void draw_list_replay(const draw_cmd_t *cmd)
+{
+    switch (cmd->kind) {
+        case DRAW_FILL:
+            render_fill(cmd->x, cmd->y, cmd->w, cmd->h, cmd->color);
+            break;
+        case DRAW_BALL:
+            render_fill_ball(cmd->x, cmd->y, cmd->color);
+            break;
+        case DRAW_GLYPH:
+            render_glyph(cmd->x, cmd->y, cmd->bitmap, cmd->rows, cmd->scale, cmd->color);
+            break;
+        default:
+            break;
+    }
+}
+
+static void draw_list_push(draw_kind_t kind, int x, int y, int w, int h, const uint8_t *bitmap,
+                           int rows, int scale, uint16_t color)
+{
+    if (w <= 0 || h <= 0 || x >= SCREEN_W || y >= SCREEN_H || x + w <= 0 || y + h <= 0) {
+        return;
+    }
+    draw_cmd_t cmd = {
+        .bitmap = bitmap,
+        .x = (int16_t)x,
+        .y = (int16_t)y,
+        .w = (int16_t)w,
+        .h = (int16_t)h,
+        .color = color,
+        .kind = (uint8_t)kind,
+        .rows = (uint8_t)rows,
+        .scale = (uint8_t)scale,
+    };
+#if ENABLE_SPRITE_LAYER
+    if (s_draw_len == DRAW_LIST_LEN && !s_immediate) {
+        // Too many calls to track: the rest of the frame is drawn straight
+        // into the framebuffer, which is redrawn and sent in full.
+        fb_wait();
+        render_clear(s_clear_color);
+        for (int n = 0; n < s_draw_len; ++n) {
+            draw_list_replay(&s_draw_list[n]);
+        }
+        memset(s_dirty_rows, 1, sizeof(s_dirty_rows));
+        s_sprites_valid = false;
+        s_resolved = true;
+        s_immediate = true;
+    }
+    if (s_immediate) {
+        fb_wait();
+        draw_list_replay(&cmd);
+        return;
+    }
+#endif
+    if (s_draw_len == DRAW_LIST_LEN) {
+        s_dropped_calls++;
+        if (!s_draw_overflow) {
+            ESP_LOGW(TAG, "Draw list full, dropping draw calls");
+            s_draw_overflow = true;
+        }
+        return;
+    }
+#if ENABLE_STRIP_RENDER
+    s_read_strip = -1;
+#else
+    s_resolved = false;
+#endif
+    s_draw_list[s_draw_len++] = cmd;
+}
+
+static uint32_t hash_mix(uint32_t hash, uint32_t value)
+{
+    return (hash ^ value) * 16777619u;
+}
+
+static uint32_t draw_cmd_hash(const draw_cmd_t *cmd)
+{
+    uint32_t hash = hash_mix(2166136261u, (uint32_t)(uintptr_t)cmd->bitmap);
+    hash = hash_mix(hash, (uint32_t)(uint16_t)cmd->x | ((uint32_t)(uint16_t)cmd->y << 16));
+    hash = hash_mix(hash, (uint32_t)(uint16_t)cmd->w | ((uint32_t)(uint16_t)cmd->h << 16));
+    hash = hash_mix(hash, cmd->color | ((uint32_t)cmd->kind << 16));
+    return hash_mix(hash, cmd->rows | ((uint32_t)cmd->scale << 8));
+}
+#endif
+
+#if ENABLE_STRIP_RENDER
+
+static int strip_of(int y)
+{
+    if (y < 0) {
+        return 0;
+    }
+    return y >= SCREEN_H ? STRIP_COUNT - 1 : y / STRIP_H;
+}
+
+static void frame_hashes(uint32_t hash[STRIP_COUNT])
+{
+    for (int i = 0; i < STRIP_COUNT; ++i) {
+        hash[i] = hash_mix(2166136261u, s_clear_color);
+    }
+    for (int n = 0; n < s_draw_len; ++n) {
+        const draw_cmd_t *cmd = &s_draw_list[n];
+        uint32_t cmd_hash = draw_cmd_hash(cmd);
+        for (int i = strip_of(cmd->y); i <= strip_of(cmd->y + cmd->h - 1); ++i) {
+            hash[i] = hash_mix(hash[i], cmd_hash);
+        }
+    }
+}
+
+static void render_strip(uint16_t *strip, int y0, int y1)
+{
+    render_bind(strip, y0);
+    render_clear(s_clear_color);
+    for (int n = 0; n < s_draw_len; ++n) {
+        const draw_cmd_t *cmd = &s_draw_list[n];
+        if (cmd->y < y1 && cmd->y + cmd->h > y0) {
+            draw_list_replay(cmd);
+        }
+    }
+}
+#elif ENABLE_SPRITE_LAYER
+static rect_t cmd_bounds(const draw_cmd_t *cmd)
+{
+    return (rect_t) { .x = cmd->x, .y = cmd->y, .w = cmd->w, .h = cmd->h };
+}
+
+static bool rect_equal(const rect_t *a, const rect_t *b)
+{
+    return a->x == b->x && a->y == b->y && a->w == b->w && a->h == b->h;
+}
+
+static int overlap_area(const rect_t *a, const rect_t *b)
+{
+    int w = (a->x + a->w < b->x + b->w ? a->x + a->w : b->x + b->w) - (a->x > b->x ? a->x : b->x);
+    int h = (a->y + a->h < b->y + b->h ? a->y + a->h : b->y + b->h) - (a->y > b->y ? a->y : b->y);
+    return w > 0 && h > 0 ? w * h : 0;
+}
+
+static bool damage_overlaps(const rect_t *r)
+{
+    for (int i = 0; i < s_damage_len; ++i) {
+        if (overlap_area(&s_damage[i], r)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Records an area whose pixels this frame rewrites. Returns false when the
+// list is full.
+static bool damage_add(int x0, int y0, int x1, int y1)
+{
+    x0 = x0 < 0 ? 0 : x0;
+    y0 = y0 < 0 ? 0 : y0;
+    x1 = x1 > SCREEN_W ? SCREEN_W : x1;
+    y1 = y1 > SCREEN_H ? SCREEN_H : y1;
+    if (x0 >= x1 || y0 >= y1) {
+        return true;
+    }
+    if (s_damage_len == DAMAGE_LEN) {
+        return false;
+    }
+    s_damage[s_damage_len++] = (rect_t) {
+        .x = (int16_t)x0,
+        .y = (int16_t)y0,
+        .w = (int16_t)(x1 - x0),
+        .h = (int16_t)(y1 - y0),
+    };
+    memset(&s_dirty_rows[y0], 1, y1 - y0);
+    return true;
+}
+
+static bool erase(int x0, int y0, int x1, int y1)
+{
+    if (x0 >= x1 || y0 >= y1) {
+        return true;
+    }
+    if (!damage_add(x0, y0, x1, y1)) {
+        return false;
+    }
+    render_fill(x0, y0, x1 - x0, y1 - y0, s_sprite_color);
+    return true;
+}
+
+// Erases what a vanished call left behind, except where `cover`, a solid
+// call that is redrawn anyway, overlaps it: at most four bands around it.
+static bool erase_exposed(const rect_t *old, const rect_t *cover)
+{
+    int x0 = old->x, y0 = old->y, x1 = old->x + old->w, y1 = old->y + old->h;
+    if (!cover || !overlap_area(old, cover)) {
+        return erase(x0, y0, x1, y1);
+    }
+    int cx0 = cover->x > x0 ? cover->x : x0;
+    int cy0 = cover->y > y0 ? cover->y : y0;
+    int cx1 = cover->x + cover->w < x1 ? cover->x + cover->w : x1;
+    int cy1 = cover->y + cover->h < y1 ? cover->y + cover->h : y1;
+    return erase(x0, y0, x1, cy0) && erase(x0, cy1, x1, y1) && erase(x0, cy0, cx0, cy1) &&
+           erase(cx1, cy0, x1, cy1);
+}
+
+// The changed solid call covering most of `old`; usually the same sprite
+// at its new position.
+static const rect_t *best_cover(const rect_t *old, rect_t *storage)
+{
+    int best_area = 0;
+    for (int n = 0; n < s_draw_len; ++n) {
+        const draw_cmd_t *cmd = &s_draw_list[n];
+        if (s_cmd_matched[n] || cmd->kind == DRAW_GLYPH) {
+            continue;
+        }
+        rect_t bounds = cmd_bounds(cmd);
+        int area = overlap_area(old, &bounds);
+        if (area > best_area) {
+            best_area = area;
+            *storage = bounds;
+        }
+    }
+    return best_area ? storage : NULL;
+}
+
+// Brings the framebuffer from s_sprites to the draw list, touching only what
+// changed. Calls of the last frame are matched in order, so unchanged ones
+// keep their stacking. Vanished calls are erased to the background; glyphs
+// are erased before they are redrawn since they only set their ink. A call
+// is redrawn when it changed or overlaps anything erased or redrawn before
+// it. Returns false if the frame changed too much; the framebuffer is then
+// in between and must be drawn in full.
+static bool sprites_update(void)
+{
+    int next = 0;
+    for (int n = 0; n < s_draw_len; ++n) {
+        const draw_cmd_t *cmd = &s_draw_list[n];
+        uint32_t hash = draw_cmd_hash(cmd);
+        rect_t bounds = cmd_bounds(cmd);
+        s_cmd_matched[n] = false;
+        int end = next + MATCH_LOOKAHEAD < s_sprite_count ? next + MATCH_LOOKAHEAD : s_sprite_count;
+        for (int k = next; k < end; ++k) {
+            if (s_sprites[k].hash == hash && rect_equal(&s_sprites[k].bounds, &bounds)) {
+                s_sprite_kept[k] = true;
+                s_cmd_matched[n] = true;
+                next = k + 1;
+                break;
+            }
+        }
+    }
+
+    for (int k = 0; k < s_sprite_count; ++k) {
+        rect_t storage;
+        if (!s_sprite_kept[k] && !erase_exposed(&s_sprites[k].bounds, best_cover(&s_sprites[k].bounds, &storage))) {
+            return false;
+        }
+    }
+    for (int n = 0; n < s_draw_len; ++n) {
+        const draw_cmd_t *cmd = &s_draw_list[n];
+        if (!s_cmd_matched[n] && cmd->kind == DRAW_GLYPH && !erase(cmd->x, cmd->y, cmd->x + cmd->w, cmd->y + cmd->h)) {
+            return false;
+        }
+    }
+    for (int n = 0; n < s_draw_len; ++n) {
+        const draw_cmd_t *cmd = &s_draw_list[n];
+        rect_t bounds = cmd_bounds(cmd);
+        if (s_cmd_matched[n] && !damage_overlaps(&bounds)) {
+            continue;
+        }
+        draw_list_replay(cmd);
+        // Changed glyphs went into the list when they were erased.
+        bool listed = !s_cmd_matched[n] && cmd->kind == DRAW_GLYPH;
+        if (!listed && !damage_add(cmd->x, cmd->y, cmd->x + cmd->w, cmd->y + cmd->h)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void sprites_resolve(void)
+{
+    if (s_resolved) {
+        return;
+    }
+    s_resolved = true;
+    fb_wait();
+    s_damage_len = 0;
+    memset(s_sprite_kept, 0, sizeof(s_sprite_kept));
+    bool incremental = s_sprites_valid && s_sprite_color == s_clear_color;
+    if (!incremental || !sprites_update()) {
+        render_clear(s_clear_color);
+        for (int n = 0; n < s_draw_len; ++n) {
+            draw_list_replay(&s_draw_list[n]);
+        }
+        memset(s_dirty_rows, 1, sizeof(s_dirty_rows));
+    }
+
+    for (int n = 0; n < s_draw_len; ++n) {
+        s_sprites[n] = (sprite_t) {
+            .bounds = cmd_bounds(&s_draw_list[n]),
+            .hash = draw_cmd_hash(&s_draw_list[n]),
+        };
+    }
+    s_sprite_count = s_draw_len;
+    s_sprite_color = s_clear_color;
+    s_sprites_valid = true;
+}
+#endif
+
+void display_init(int pclk_hz)
+{
+    ESP_LOGI(TAG, "Display init (%dx%d)", SCREEN_W, SCREEN_H);
+
+    gpio_config_t bk_conf = {
+        .pin_bit_mask = 1ULL << LCD_BLK,
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE
+    };
+    gpio_config(&bk_conf);
+    gpio_set_level(LCD_BLK, 1);
+
+    spi_bus_config_t buscfg = {
+        .sclk_io_num = LCD_SCLK,
+        .mosi_io_num = LCD_MOSI,
+        .miso_io_num = -1,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = SCREEN_W * RENDER_ROWS * 2 + 8,
+    };
+    ESP_ERROR_CHECK(spi_bus_initialize(LCD_HOST, &buscfg, SPI_DMA_CH_AUTO));
+
+#if ENABLE_STATIC_MEMORY
+    s_tx_queue = xQueueCreateStatic(TX_QUEUE_LEN, sizeof(tx_item_t), s_tx_queue_storage, &s_tx_queue_mem);
+    s_tx_task = xTaskCreateStatic(display_tx_task, "lcd_tx", TX_STACK_SIZE, NULL, TX_TASK_PRIORITY, s_tx_stack,
+                                  &s_tx_task_mem);
+#if ENABLE_STRIP_RENDER
+    s_strip_free = xSemaphoreCreateCountingStatic(2, 2, &s_strip_free_mem);
+#else
+    s_fb_free = xSemaphoreCreateBinaryStatic(&s_fb_free_mem);
+#endif
+#else
+    s_tx_queue = xQueueCreate(TX_QUEUE_LEN, sizeof(tx_item_t));
+    if (!s_tx_queue || xTaskCreate(display_tx_task, "lcd_tx", TX_STACK_SIZE, NULL, TX_TASK_PRIORITY, &s_tx_task) != pdPASS) {
+        ESP_LOGE(TAG, "Display sender task creation failed");
+        return;
+    }
+#if ENABLE_STRIP_RENDER
+    s_strip_free = xSemaphoreCreateCounting(2, 2);
+    if (!s_strip_free) {
+        ESP_LOGE(TAG, "Strip semaphore allocation failed");
+        return;
+    }
+#else
+    s_fb_free = xSemaphoreCreateBinary();
+    if (!s_fb_free) {
+        ESP_LOGE(TAG, "Framebuffer semaphore allocation failed");
+        return;
+    }
+#endif
+#endif
+
+    esp_lcd_panel_io_handle_t io_handle = NULL;
+    esp_lcd_panel_io_spi_config_t io_config = {
+        .dc_gpio_num = LCD_DC,
+        .cs_gpio_num = LCD_CS,
+        .pclk_hz = pclk_hz,
+        .lcd_cmd_bits = 8,
+        .lcd_param_bits = 8,
+        .spi_mode = 0,
+        .trans_queue_depth = 10,
+        .on_color_trans_done = on_color_sent,
+    };
+    ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)LCD_HOST, &io_config, &io_handle));
+
+    esp_lcd_panel_dev_config_t panel_config = {
+        .reset_gpio_num = LCD_RST,
+        .color_space = LCD_COLOR_SPACE,
+        .bits_per_pixel = 16,
+    };
+    // ILI9341 panels run on the ST7789 driver: esp_lcd ships no ILI9341
+    // driver, and the commands it sends (SLPOUT, MADCTL, COLMOD, CASET,
+    // RASET, RAMWR, DISPON) are common to both controllers.
+    ESP_ERROR_CHECK(esp_lcd_new_panel_st7789(io_handle, &panel_config, &s_panel));
+
+    ESP_ERROR_CHECK(esp_lcd_panel_reset(s_panel));
+    ESP_ERROR_CHECK(esp_lcd_panel_init(s_panel));
+    ESP_ERROR_CHECK(esp_lcd_panel_mirror(s_panel, LCD_MIRROR_X, LCD_MIRROR_Y));
+    ESP_ERROR_CHECK(esp_lcd_panel_swap_xy(s_panel, LCD_SWAP_XY));
+    ESP_ERROR_CHECK(esp_lcd_panel_set_gap(s_panel, LCD_OFFSET_X, LCD_OFFSET_Y));
+    ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(s_panel, true));
+
+#if ENABLE_STRIP_RENDER
+    size_t strip_size = SCREEN_W * STRIP_H * sizeof(uint16_t);
+    for (int i = 0; i < 2; ++i) {
+#if ENABLE_STATIC_MEMORY
+        s_strips[i] = s_strip_mem[i];
+#else
+        s_strips[i] = heap_caps_malloc(strip_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!s_strips[i]) {
+            ESP_LOGE(TAG, "Strip buffer allocation failed");
+            return;
+        }
+#endif
+    }
+    ESP_LOGI(TAG, "Strip rendering: %d strips of %d rows, 2 x %u bytes", STRIP_COUNT, STRIP_H,
+             (unsigned)strip_size);
+#else
+#if ENABLE_STATIC_MEMORY
+    s_framebuffer = s_framebuffer_mem;
+#else
+    size_t fb_size = SCREEN_W * SCREEN_H * sizeof(uint16_t);
+    s_framebuffer = heap_caps_malloc(fb_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!s_framebuffer) {
+        ESP_LOGE(TAG, "Framebuffer allocation failed");
+        return;
+    }
+#endif
+    render_bind(s_framebuffer, 0);
+#endif
+
+    display_clear(COLOR_BLACK);
+    display_flush();
+}
+
+void display_clear(uint16_t color)
+{
+#if ENABLE_STRIP_RENDER
+    // Everything drawn so far is covered anyway.
+    s_clear_color = color;
+    s_draw_len = 0;
+    s_read_strip = -1;
+#elif ENABLE_SPRITE_LAYER
+    // Nothing is erased yet: flush compares the frame with the last one.
+    s_clear_color = color;
+    s_draw_len = 0;
+    s_resolved = false;
+    s_immediate = false;
+#else
+    fb_wait();
+    render_clear(color);
+#endif
+}
+
+void display_draw_rect(int x, int y, int w, int h, uint16_t color)
+{
+#if ENABLE_DRAW_LIST
+    draw_list_push(DRAW_FILL, x, y, w, h, NULL, 0, 0, color);
+#else
+    fb_wait();
+    render_fill(x, y, w, h, color);
+#endif
+}
+
+void display_draw_ball(int x, int y, uint16_t color)
+{
+#if ENABLE_DRAW_LIST
+    draw_list_push(DRAW_BALL, x, y, BALL_SIZE, BALL_SIZE, NULL, 0, 0, color);
+#else
+    fb_wait();
+    render_fill_ball(x, y, color);
+#endif
+}
+
+static void display_glyph(int x, int y, const uint8_t *bitmap, int rows, int scale, uint16_t color)
+{
+#if ENABLE_DRAW_LIST
+    draw_list_push(DRAW_GLYPH, x, y, 8 * scale, rows * scale, bitmap, rows, scale, color);
+#else
+    fb_wait();
+    render_glyph(x, y, bitmap, rows, scale, color);
+#endif
+}
+
+#if CONFIG_PONG_RENDER_BENCH
+// The generic routines the render core replaced, kept as the benchmark
+// baseline and to check that both produce the same pixels.
+static void ref_clear(uint16_t color)
+{
+    for (int i = 0; i < SCREEN_W * SCREEN_H; ++i) {
+        s_framebuffer[i] = color;
+    }
+}
+
+static void ref_draw_rect(int x, int y, int w, int h, uint16_t color)
+{
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if (x + w > SCREEN_W) {
+        w = SCREEN_W - x;
+    }
+    if (y + h > SCREEN_H) {
+        h = SCREEN_H - y;
+    }
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+
+    for (int yy = y; yy < y + h; ++yy) {
+        uint16_t *row = s_framebuffer + yy * SCREEN_W + x;
+        for (int xx = 0; xx < w; ++xx) {
+            row[xx] = color;
+        }
+    }
+}
+#endif
+
+esp_err_t display_submit_batch(const display_window_t *windows, int count, display_batch_done_fn done, void *ctx)
+{
+    if (!s_tx_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (int i = 0; i < count; ++i) {
+        s_flushed_bytes += (uint64_t)windows[i].w * windows[i].h * sizeof(uint16_t);
+    }
+    if (count <= 0 || s_null_panel) {
+        if (done) {
+            done(ctx);
+        }
+        return ESP_OK;
+    }
+
+    tx_pending_add(count);
+    for (int i = 0; i < count; ++i) {
+        tx_item_t item = {
+            .window = windows[i],
+            .done = done,
+            .ctx = ctx,
+            .last = i == count - 1,
+        };
+        xQueueSend(s_tx_queue, &item, portMAX_DELAY);
+    }
+    return ESP_OK;
+}
+
+#if ENABLE_STRIP_RENDER
+void display_flush(void)
+{
+    if (!s_panel || !s_strips[1]) {
+        return;
+    }
+
+    uint32_t hash[STRIP_COUNT];
+    frame_hashes(hash);
+
+    for (int i = 0; i < STRIP_COUNT; ++i) {
+        if (s_strip_hash_valid && hash[i] == s_strip_hash[i]) {
+            continue;
+        }
+        s_strip_hash[i] = hash[i];
+
+        int y0 = i * STRIP_H;
+        int y1 = y0 + STRIP_H < SCREEN_H ? y0 + STRIP_H : SCREEN_H;
+        uint16_t *strip = s_strips[s_next_strip];
+        s_next_strip ^= 1;
+        // Transfers complete in order, so a free slot means this buffer,
+        // submitted two strips ago, has been sent.
+        xSemaphoreTake(s_strip_free, portMAX_DELAY);
+
+        render_strip(strip, y0, y1);
+        display_window_t window = { .x = 0, .y = (int16_t)y0, .w = SCREEN_W, .h = (int16_t)(y1 - y0), .pixels = strip };
+        display_submit_batch(&window, 1, on_strip_sent, NULL);
+    }
+    s_strip_hash_valid = true;
+    s_draw_len = 0;
+    s_read_strip = -1;
+}
+
+void display_read_rect(int x, int y, int w, int h, uint16_t *dst)
+{
+    if (!s_strips[1]) {
+        return;
+    }
+    uint16_t *strip = s_strips[s_next_strip];
+    for (int row = y; row < y + h; ++row, dst += w) {
+        int i = row / STRIP_H;
+        if (i != s_read_strip) {
+            // The buffer flush would fill next: idle once a slot is free.
+            xSemaphoreTake(s_strip_free, portMAX_DELAY);
+            int y0 = i * STRIP_H;
+            render_strip(strip, y0, y0 + STRIP_H < SCREEN_H ? y0 + STRIP_H : SCREEN_H);
+            xSemaphoreGive(s_strip_free);
+            s_read_strip = i;
+        }
+        memcpy(dst, strip + (row % STRIP_H) * SCREEN_W + x, w * sizeof(uint16_t));
+    }
+}
+
+void display_mark_presented(void)
+{
+    frame_hashes(s_strip_hash);
+    s_strip_hash_valid = true;
+    s_draw_len = 0;
+    s_read_strip = -1;
+}
+#elif ENABLE_SPRITE_LAYER
+void display_flush(void)
+{
+    if (!s_panel || !s_framebuffer) {
+        return;
+    }
+    sprites_resolve();
+    fb_wait();
+
+    // Changed rows go out as full-width bands straight from the framebuffer.
+    display_window_t windows[FLUSH_WINDOWS];
+    int count = 0;
+    for (int y = 0; y < SCREEN_H;) {
+        if (!s_dirty_rows[y]) {
+            ++y;
+            continue;
+        }
+        int y0 = y;
+        while (y < SCREEN_H && s_dirty_rows[y]) {
+            s_dirty_rows[y++] = false;
+        }
+        if (count == FLUSH_WINDOWS) {
+            fb_submit(windows, count, false);
+            count = 0;
+        }
+        windows[count++] = (display_window_t) {
+            .x = 0,
+            .y = (int16_t)y0,
+            .w = SCREEN_W,
+            .h = (int16_t)(y - y0),
+            .pixels = s_framebuffer + y0 * SCREEN_W,
+        };
+    }
+    if (count) {
+        fb_submit(windows, count, true);
+    }
+}
+
+void display_read_rect(int x, int y, int w, int h, uint16_t *dst)
+{
+    if (!s_framebuffer) {
+        return;
+    }
+    sprites_resolve();
+    for (int row = y; row < y + h; ++row, dst += w) {
+        memcpy(dst, s_framebuffer + row * SCREEN_W + x, w * sizeof(uint16_t));
+    }
+}
+
+void display_mark_presented(void)
+{
+    sprites_resolve();
+    memset(s_dirty_rows, 0, sizeof(s_dirty_rows));
+}
+#else
+void display_flush(void)
+{
+    if (!s_panel || !s_framebuffer) {
+        return;
+    }
+    fb_wait();
+    display_window_t window = { .x = 0, .y = 0, .w = SCREEN_W, .h = SCREEN_H, .pixels = s_framebuffer };
+    fb_submit(&window, 1, true);
+}
+
+void display_read_rect(int x, int y, int w, int h, uint16_t *dst)
+{
+    if (!s_framebuffer) {
+        return;
+    }
+    for (int row = y; row < y + h; ++row, dst += w) {
+        memcpy(dst, s_framebuffer + row * SCREEN_W + x, w * sizeof(uint16_t));
+    }
+}
+
+void display_mark_presented(void)
+{
+}
+#endif
+
+void display_set_null_panel(bool enable)
+{
+    s_null_panel = enable;
+}
+
+void display_invalidate(void)
+{
+#if ENABLE_STRIP_RENDER
+    s_strip_hash_valid = false;
+#elif ENABLE_SPRITE_LAYER
+    s_sprites_valid = false;
+    if (s_immediate) {
+        // The framebuffer already holds the whole frame.
+        memset(s_dirty_rows, 1, sizeof(s_dirty_rows));
+    } else {
+        s_resolved = false;
+    }
+#endif
+}
+
+uint64_t display_flushed_bytes(void)
+{
+    return s_flushed_bytes;
+}
+
+uint64_t display_dropped_calls(void)
+{
+    return s_dropped_calls;
+}
+
+int display_pending_transfers(void)
+{
+    portENTER_CRITICAL(&s_tx_lock);
+    int pending = s_tx_pending;
+    portEXIT_CRITICAL(&s_tx_lock);
+    return pending;
+}
+
+void draw_char(int x, int y, char c, int scale)
+{
+    uint8_t index = (uint8_t)c;
+    if (index > 127) {
+        index = (uint8_t)'?';
+    }
+    display_glyph(x, y, font8x8_basic[index], 8, scale, COLOR_WHITE);
+}
+
+static const font_glyph_t *font_glyph(char c)
+{
+    uint8_t index = (uint8_t)c;
+    if (index < FONT_PROP_FIRST || index > FONT_PROP_LAST) {
+        index = (uint8_t)'?';
+    }
+    return &g_font_prop_glyphs[index - FONT_PROP_FIRST];
+}
+
+// Pen movement from `c` to `next` at scale 1, kerning included.
+static int font_advance(char c, char next)
+{
+    const font_glyph_t *glyph = font_glyph(c);
+    int index = (int)(glyph - g_font_prop_glyphs);
+    for (int i = g_font_prop_kern_index[index]; i < g_font_prop_kern_index[index + 1]; ++i) {
+        if (g_font_prop_kern[i].second == (uint8_t)next) {
+            return glyph->advance + g_font_prop_kern[i].adjust;
+        }
+    }
+    return glyph->advance;
+}
+
+void draw_text(int x, int y, const char *text, int scale)
+{
+    for (const char *p = text; *p; ++p) {
+        const font_glyph_t *glyph = font_glyph(*p);
+        if (glyph->rows) {
+            display_glyph(x + glyph->left * scale, y + glyph->top * scale, &g_font_prop_bitmaps[glyph->offset],
+                          glyph->rows, scale, COLOR_WHITE);
+        }
+        x += font_advance(*p, p[1]) * scale;
+    }
+}
+
+int text_width(const char *text, int scale)
+{
+    int width = 0;
+    for (const char *p = text; *p; ++p) {
+        width += font_advance(*p, p[1]);
+    }
+    return width * scale;
+}
+
+void draw_text_centered(int y, const char *text, int scale)
+{
+    draw_text((SCREEN_W - text_width(text, scale)) / 2, y, text, scale);
+}
+
+static const uint8_t heart_filled[7] = {
+    0x6C, 0xFE, 0xFE, 0xFE, 0x7C, 0x38, 0x10
+};
+static const uint8_t heart_outline[7] = {
+    0x6C, 0x92, 0x82, 0x44, 0x28, 0x10, 0x00
+};
+
+void draw_heart(int x, int y, int scale, bool filled)
+{
+    display_glyph(x, y, filled ? heart_filled : heart_outline, 7, scale, COLOR_WHITE);
+}
+
+#if CONFIG_PONG_RENDER_BENCH
+static void ref_draw_bitmap(int x, int y, const uint8_t *bitmap, int rows, int scale)
+{
+    for (int row = 0; row < rows; ++row) {
+        uint8_t bits = bitmap[row];
+        for (int col = 0; col < 8; ++col) {
+            if (bits & (1 << (7 - col))) {
+                ref_draw_rect(x + col * scale, y + row * scale, scale, scale, COLOR_WHITE);
+            }
+        }
+    }
+}
+
+static void fixed_draw_text(int x, int y, const char *text, int scale)
+{
+    for (const char *p = text; *p; ++p) {
+        draw_char(x, y, *p, scale);
+        x += (8 * scale) + scale;
+    }
+}
+
+static void ref_draw_text(int x, int y, const char *text, int scale)
+{
+    for (const char *p = text; *p; ++p) {
+        ref_draw_bitmap(x, y, font8x8_basic[(uint8_t)*p & 0x7F], 8, scale);
+        x += (8 * scale) + scale;
+    }
+}
+
+// A typical in-game frame: HUD text at both scales, hearts, paddle, ball
+// and a few clipped shapes at the edges.
+static void bench_scene(bool reference)
+{
+    if (reference) {
+        ref_clear(COLOR_BLACK);
+        ref_draw_text(2, 2, "H:42", 2);
+        ref_draw_text(2, 20, "R:9000us Q:0 S:1", 1);
+        ref_draw_text(SCREEN_W / 2 - 20, SCREEN_H / 2 - 4, "PAUSE", 1);
+        for (int i = 0; i < 3; ++i) {
+            ref_draw_bitmap(SCREEN_W - 32 + i * 10, 2, i ? heart_outline : heart_filled, 7, 1);
+        }
+        ref_draw_rect(80, SCREEN_H - 6, 48, 4, COLOR_WHITE);
+        for (int i = 0; i < 16; ++i) {
+            ref_draw_rect(i * 15, 40 + (i % 4) * 6, BALL_SIZE, BALL_SIZE, COLOR_WHITE);
+        }
+        ref_draw_rect(-3, -3, 10, 10, COLOR_WHITE);
+        ref_draw_text(SCREEN_W - 12, SCREEN_H - 6, "X", 2);
+    } else {
+        display_clear(COLOR_BLACK);
+        fixed_draw_text(2, 2, "H:42", 2);
+        fixed_draw_text(2, 20, "R:9000us Q:0 S:1", 1);
+        fixed_draw_text(SCREEN_W / 2 - 20, SCREEN_H / 2 - 4, "PAUSE", 1);
+        for (int i = 0; i < 3; ++i) {
+            draw_heart(SCREEN_W - 32 + i * 10, 2, 1, i == 0);
+        }
+        display_draw_rect(80, SCREEN_H - 6, 48, 4, COLOR_WHITE);
+        for (int i = 0; i < 16; ++i) {
+            display_draw_ball(i * 15, 40 + (i % 4) * 6, COLOR_WHITE);
+        }
+        display_draw_rect(-3, -3, 10, 10, COLOR_WHITE);
+        fixed_draw_text(SCREEN_W - 12, SCREEN_H - 6, "X", 2);
+    }
+}
+
+static uint32_t framebuffer_checksum(void)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < SCREEN_W * SCREEN_H; ++i) {
+        sum = sum * 31 + s_framebuffer[i];
+    }
+    return sum;
+}
+
+void display_render_bench(void)
+{
+    if (!s_framebuffer) {
+        return;
+    }
+    fb_wait();
+    const int iterations = 200;
+    int64_t elapsed[2];
+    uint32_t checksum[2];
+    for (int pass = 0; pass < 2; ++pass) {
+        bool reference = pass == 0;
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < iterations; ++i) {
+            bench_scene(reference);
+#if ENABLE_SPRITE_LAYER
+            // Time drawing the whole frame, as without the sprite layer.
+            if (!reference) {
+                display_invalidate();
+                sprites_resolve();
+            }
+#endif
+        }
+        elapsed[pass] = esp_timer_get_time() - start;
+        checksum[pass] = framebuffer_checksum();
+    }
+    ESP_LOGI(TAG, "Render bench: generic %lld us/frame, specialised %lld us/frame, pixels %s",
+             (long long)(elapsed[0] / iterations), (long long)(elapsed[1] / iterations),
+             checksum[0] == checksum[1] ? "identical" : "DIFFER");
+    display_clear(COLOR_BLACK);
+}
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "game_config.h"
+#include "sdkconfig.h"
+
+// LCD pins (as provided)
+#define LCD_MOSI 23
+#define LCD_SCLK 18
+#define LCD_CS   15
+#define LCD_DC    2
+#define LCD_RST   CONFIG_PONG_LCD_RST_GPIO
+#define LCD_BLK  32
+
+#define LCD_PCLK_HZ (40 * 1000 * 1000)
+
+#define COLOR_BLACK 0x0000
+#define COLOR_WHITE 0xFFFF
+
+// HUD layout grows with the panel: text and icons are drawn one scale step
+// larger on panels at least 200 rows tall, and margins follow.
+#define UI_SCALE (SCREEN_H >= 200 ? 2 : 1)
+#define UI_MARGIN (2 * UI_SCALE)
+
+// RGB565 output on an ST7789 (or ILI9341) panel, shared by all games. Small
+// panels draw into a full framebuffer. With CONFIG_PONG_STRIP_RENDER drawing
+// only records the calls, and display_flush() replays them strip by strip
+// into two DMA buffers, sending only strips that changed.
+void display_init(int pclk_hz);
+void display_clear(uint16_t color);
+void display_draw_rect(int x, int y, int w, int h, uint16_t color);
+// BALL_SIZE square; the fixed size lets the render core unroll it.
+void display_draw_ball(int x, int y, uint16_t color);
+void display_flush(void);
+
+// Benchmark support. With the null panel on, flushes do all their work
+// except handing pixels to the SPI driver. display_invalidate() makes the
+// next flush resend every strip. display_flushed_bytes() counts the pixel
+// bytes flushed so far, null panel included. display_dropped_calls() counts
+// draw calls lost to a full draw list; only strip rendering drops any.
+void display_set_null_panel(bool enable);
+void display_invalidate(void);
+uint64_t display_flushed_bytes(void);
+uint64_t display_dropped_calls(void);
+
+// Copies a w x h rectangle of the frame drawn since the last flush into
+// `dst`, row-major, without sending anything. The rectangle must lie on
+// screen.
+void display_read_rect(int x, int y, int w, int h, uint16_t *dst);
+
+// Ends a frame whose pixels reached the panel through display_read_rect()
+// and display_submit_batch() instead of display_flush().
+void display_mark_presented(void);
+
+// Windows submitted and not yet completely sent.
+int display_pending_transfers(void);
+
+// A rectangle of RGB565 pixels, row-major and tightly packed, in DMA-capable
+// memory.
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    const uint16_t *pixels;
+} display_window_t;
+
+typedef void (*display_batch_done_fn)(void *ctx);
+
+// Queues a list of windows to be sent back to back and returns without
+// waiting for the bus; it only blocks when more windows are outstanding than
+// the sender queue holds. Each window's pixels must stay untouched until
+// `done` (may be NULL) runs, once, from the sender task after the last window
+// has been sent. Windows of one batch go out in order.
+esp_err_t display_submit_batch(const display_window_t *windows, int count, display_batch_done_fn done, void *ctx);
+
+// One cell of the fixed-width 8x8 font, scaled by whole pixels.
+void draw_char(int x, int y, char c, int scale);
+// Proportional font (font_prop.h) with kerning, scaled by whole pixels. Text
+// is measured from the glyph metrics alone, in one pass.
+void draw_text(int x, int y, const char *text, int scale);
+// Width draw_text() advances over, including the trailing spacing.
+int text_width(const char *text, int scale);
+void draw_text_centered(int y, const char *text, int scale);
+void draw_heart(int x, int y, int scale, bool filled);
+
+#if CONFIG_PONG_RENDER_BENCH
+// Times a typical frame through the old generic routines and the render
+// core, and checks that both produce the same pixels.
+void display_render_bench(void);
+#endif
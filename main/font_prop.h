@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+// Proportional font for printable ASCII, generated at build time by
+// tools/gen_font.py from font8x8_basic.h. Glyphs are trimmed to their ink:
+// `rows` bytes starting at `offset` in g_font_prop_bitmaps, MSB = leftmost
+// inked column, drawn at (pen + left, top) within the 8x8 cell. `advance`
+// includes the one column of spacing. All metrics are at scale 1.
+
+#define FONT_PROP_FIRST ' '
+#define FONT_PROP_LAST '~'
+#define FONT_PROP_COUNT (FONT_PROP_LAST - FONT_PROP_FIRST + 1)
+
+typedef struct {
+    uint16_t offset;
+    uint8_t advance;
+    uint8_t left;
+    uint8_t top;
+    uint8_t width;
+    uint8_t rows;
+} font_glyph_t;
+
+// Pen adjustment between a glyph and the following `second` character.
+typedef struct {
+    uint8_t second;
+    int8_t adjust;
+} font_kern_t;
+
+extern const font_glyph_t g_font_prop_glyphs[FONT_PROP_COUNT];
+extern const uint8_t g_font_prop_bitmaps[];
+// Pairs starting with glyph i are g_font_prop_kern[index[i] .. index[i + 1]).
+extern const uint16_t g_font_prop_kern_index[FONT_PROP_COUNT + 1];
+extern const font_kern_t g_font_prop_kern[];
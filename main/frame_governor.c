@@ -0,0 +1,157 @@
+#include "frame_governor.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#define TAG "governor"
+
+// Never run more than this many simulation steps in one loop iteration;
+// beyond that the game would stutter through a burst of catch-up steps.
+#define MAX_CATCHUP_STEPS 4
+
+// Frames over budget before degrading, frames comfortably under before
+// restoring quality. Recovery is deliberately slower to avoid oscillation.
+#define DEGRADE_AFTER_FRAMES 8
+#define RECOVER_AFTER_FRAMES 120
+#define RECOVER_THRESHOLD_PCT 60
+
+#define MAX_SKIP_INTERVAL 3
+
+static const char *quality_name(render_quality_t quality)
+{
+    switch (quality) {
+        case QUALITY_FULL:
+            return "full";
+        case QUALITY_REDUCED:
+            return "reduced";
+        case QUALITY_MINIMAL:
+            return "minimal";
+        default:
+            return "?";
+    }
+}
+
+void governor_init(frame_governor_t *gov, int64_t tick_us, int64_t budget_us)
+{
+    *gov = (frame_governor_t) {
+        .tick_us = tick_us,
+        .budget_us = budget_us,
+        .quality = QUALITY_FULL,
+        .skip_interval = 1,
+    };
+    governor_reset_clock(gov);
+}
+
+void governor_reset_clock(frame_governor_t *gov)
+{
+    gov->last_us = esp_timer_get_time();
+    gov->accumulator_us = 0;
+}
+
+void governor_set_timing(frame_governor_t *gov, int64_t tick_us, int64_t budget_us)
+{
+    if (tick_us <= 0 || budget_us <= 0) {
+        return;
+    }
+    gov->tick_us = tick_us;
+    gov->budget_us = budget_us;
+    if (gov->accumulator_us >= tick_us) {
+        gov->accumulator_us = tick_us - 1;
+    }
+}
+
+int governor_begin_frame(frame_governor_t *gov)
+{
+    int64_t now = esp_timer_get_time();
+    gov->accumulator_us += now - gov->last_us;
+    gov->last_us = now;
+
+    int steps = (int)(gov->accumulator_us / gov->tick_us);
+    gov->accumulator_us -= (int64_t)steps * gov->tick_us;
+    if (steps > MAX_CATCHUP_STEPS) {
+        gov->dropped_steps += (uint32_t)(steps - MAX_CATCHUP_STEPS);
+        steps = MAX_CATCHUP_STEPS;
+    }
+    return steps;
+}
+
+bool governor_should_present(frame_governor_t *gov)
+{
+    if (++gov->skip_counter < gov->skip_interval) {
+        gov->skipped++;
+        return false;
+    }
+    gov->skip_counter = 0;
+    gov->presented++;
+    return true;
+}
+
+static void governor_set_quality(frame_governor_t *gov, render_quality_t quality, int skip_interval)
+{
+    if (quality == gov->quality && skip_interval == gov->skip_interval) {
+        return;
+    }
+    ESP_LOGI(TAG, "Quality %s -> %s, present 1/%d (avg %lld us, budget %lld us)",
+             quality_name(gov->quality), quality_name(quality), skip_interval,
+             (long long)gov->work_avg_us, (long long)gov->budget_us);
+    gov->quality = quality;
+    gov->skip_interval = skip_interval;
+    gov->skip_counter = 0;
+    gov->over_budget_frames = 0;
+    gov->under_budget_frames = 0;
+}
+
+void governor_end_frame(frame_governor_t *gov, int64_t work_us)
+{
+    // Exponential moving average, weight 1/8.
+    gov->work_avg_us += (work_us - gov->work_avg_us) / 8;
+
+    // Work is spread over skip_interval ticks when frames are skipped.
+    int64_t budget = gov->budget_us * gov->skip_interval;
+    if (gov->work_avg_us > budget) {
+        gov->under_budget_frames = 0;
+        if (++gov->over_budget_frames < DEGRADE_AFTER_FRAMES) {
+            return;
+        }
+        if (gov->quality != QUALITY_MINIMAL) {
+            governor_set_quality(gov, gov->quality + 1, gov->skip_interval);
+        } else if (gov->skip_interval < MAX_SKIP_INTERVAL) {
+            governor_set_quality(gov, gov->quality, gov->skip_interval + 1);
+        }
+        gov->over_budget_frames = 0;
+    } else if (gov->work_avg_us * 100 < budget * RECOVER_THRESHOLD_PCT) {
+        gov->over_budget_frames = 0;
+        if (++gov->under_budget_frames < RECOVER_AFTER_FRAMES) {
+            return;
+        }
+        if (gov->skip_interval > 1) {
+            governor_set_quality(gov, gov->quality, gov->skip_interval - 1);
+        } else if (gov->quality != QUALITY_FULL) {
+            governor_set_quality(gov, gov->quality - 1, gov->skip_interval);
+        }
+        gov->under_budget_frames = 0;
+    } else {
+        gov->over_budget_frames = 0;
+        gov->under_budget_frames = 0;
+    }
+}
+
+unsigned governor_render_flags(const frame_governor_t *gov)
+{
+    switch (gov->quality) {
+        case QUALITY_FULL:
+            return RENDER_EFFECTS | RENDER_OVERLAY | RENDER_HUD_FULL;
+        case QUALITY_REDUCED:
+            return RENDER_HUD_FULL;
+        case QUALITY_MINIMAL:
+        default:
+            return 0;
+    }
+}
+
+int64_t governor_time_to_next_step(const frame_governor_t *gov)
+{
+    int64_t elapsed = esp_timer_get_time() - gov->last_us;
+    int64_t remaining = gov->tick_us - gov->accumulator_us - elapsed;
+    return remaining > 0 ? remaining : 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Optional render work that the governor may shed when frames run long.
+#define RENDER_EFFECTS  (1u << 0)
+#define RENDER_OVERLAY  (1u << 1)
+#define RENDER_HUD_FULL (1u << 2)
+
+typedef enum {
+    QUALITY_FULL,
+    QUALITY_REDUCED,
+    QUALITY_MINIMAL
+} render_quality_t;
+
+typedef struct {
+    int64_t tick_us;
+    int64_t budget_us;
+    int64_t last_us;
+    int64_t accumulator_us;
+    int64_t work_avg_us;
+    render_quality_t quality;
+    int over_budget_frames;
+    int under_budget_frames;
+    int skip_interval;
+    int skip_counter;
+    uint32_t presented;
+    uint32_t skipped;
+    uint32_t dropped_steps;
+} frame_governor_t;
+
+// Fixed-timestep governor: the simulation advances in tick_us steps no matter
+// how long rendering takes, and render quality adapts to stay within budget_us.
+void governor_init(frame_governor_t *gov, int64_t tick_us, int64_t budget_us);
+void governor_reset_clock(frame_governor_t *gov);
+
+// Changes the step length and render budget; keeps quality and statistics.
+void governor_set_timing(frame_governor_t *gov, int64_t tick_us, int64_t budget_us);
+
+// Returns how many simulation steps are due since the previous call.
+int governor_begin_frame(frame_governor_t *gov);
+
+// Returns false when this frame should be simulated but not presented.
+bool governor_should_present(frame_governor_t *gov);
+
+// Reports how long render + flush took for a presented frame.
+void governor_end_frame(frame_governor_t *gov, int64_t work_us);
+
+unsigned governor_render_flags(const frame_governor_t *gov);
+
+// Microseconds until the next simulation step is due.
+int64_t governor_time_to_next_step(const frame_governor_t *gov);
@@ -0,0 +1,351 @@
+#include "game.h"
+
+#include "difficulty.h"
+#include "esp_log.h"
+#include "rng.h"
+#include "state_hash.h"
+
+#include <stdlib.h>
+
+#define TAG "game"
+
+#ifdef CONFIG_PONG_PHYSICS_CHECKS
+#define ENABLE_PHYSICS_CHECKS 1
+#else
+#define ENABLE_PHYSICS_CHECKS 0
+#endif
+
+// Fixed-point direction table: sin (horizontal) and cos (vertical) of the
+// bounce angle measured from the vertical, scaled by BALL_DIR_ONE. Entries are
+// Pythagorean triples, so sin^2 + cos^2 == BALL_DIR_ONE^2 holds exactly and
+// reflections never change the speed magnitude.
+#define DIRECTIONS(X) \
+    X(36, 77)  /* 25.1 deg */ \
+    X(51, 68)  /* 36.9 deg */ \
+    X(68, 51)  /* 53.1 deg */ \
+    X(75, 40)  /* 61.9 deg */
+
+#define DIR_SIN(s, c) s,
+#define DIR_COS(s, c) c,
+#define DIR_CHECK(s, c) \
+    _Static_assert((s) * (s) + (c) * (c) == BALL_DIR_ONE * BALL_DIR_ONE, "direction off the unit circle");
+
+DIRECTIONS(DIR_CHECK)
+
+static const int8_t k_dir_sin[] = { DIRECTIONS(DIR_SIN) };
+static const int8_t k_dir_cos[] = { DIRECTIONS(DIR_COS) };
+
+// Direction index and horizontal sign per paddle segment, left to right.
+// Edges send the ball out flat, the centre sends it back steeply.
+static const int8_t k_paddle_dir[PADDLE_SEGMENTS] = { 3, 2, 1, 0, 0, 1, 2, 3 };
+static const int8_t k_paddle_sign[PADDLE_SEGMENTS] = { -1, -1, -1, -1, 1, 1, 1, 1 };
+
+#define DIR_COUNT ((int)sizeof(k_dir_sin))
+
+_Static_assert(sizeof(k_dir_sin) == sizeof(k_dir_cos), "direction tables differ in length");
+
+static void ball_set_direction(ball_t *ball, int speed, int dir, int sign_x, int sign_y)
+{
+    if (dir >= DIR_COUNT) {
+        dir = DIR_COUNT - 1;
+    }
+    ball->vx = sign_x * speed * k_dir_sin[dir];
+    ball->vy = sign_y * speed * k_dir_cos[dir];
+}
+
+static int paddle_segment(const paddle_t *paddle, int ball_center)
+{
+    int offset = ball_center - paddle->x;
+    if (offset < 0) {
+        offset = 0;
+    }
+    if (offset >= paddle->w) {
+        offset = paddle->w - 1;
+    }
+    return offset * PADDLE_SEGMENTS / paddle->w;
+}
+
+// Power-up drops: one every POWERUP_EVERY_HITS paddle hits, falling one
+// pixel per step. Durations are in simulation steps.
+#define POWERUP_EVERY_HITS 5
+#define POWERUP_DROP_Y 20
+#define WIDE_PADDLE_STEPS 600
+#define SLOW_BALL_STEPS 450
+// While slowed, the ball skips every SLOW_BALL_SKIP-th step.
+#define SLOW_BALL_SKIP 3
+
+static void paddle_update_width(game_t *game)
+{
+    paddle_t *paddle = &game->paddle;
+    int w = difficulty_for_hits(game->hits)->paddle_w;
+    if (powerups_effect_active(&game->powerups, POWERUP_WIDE_PADDLE)) {
+        w = w * 3 / 2;
+    }
+    if (w != paddle->w) {
+        paddle->x += (paddle->w - w) / 2;
+        paddle->w = w;
+        if (paddle->x < 0) {
+            paddle->x = 0;
+        }
+        if (paddle->x > SCREEN_W - w) {
+            paddle->x = SCREEN_W - w;
+        }
+    }
+}
+
+static void powerup_collect(game_t *game, powerup_type_t type)
+{
+    switch (type) {
+        case POWERUP_WIDE_PADDLE:
+            powerups_start_effect(&game->powerups, type, game->tick, WIDE_PADDLE_STEPS);
+            paddle_update_width(game);
+            break;
+        case POWERUP_SLOW_BALL:
+            powerups_start_effect(&game->powerups, type, game->tick, SLOW_BALL_STEPS);
+            break;
+        case POWERUP_EXTRA_HEART:
+            if (game->bonus_lives < MAX_BONUS_LIVES) {
+                game->bonus_lives++;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void powerups_step(game_t *game)
+{
+    powerups_t *pu = &game->powerups;
+    unsigned ended = powerups_expire(pu, game->tick);
+    if (ended & (1u << POWERUP_WIDE_PADDLE)) {
+        paddle_update_width(game);
+    }
+
+    int paddle_y = SCREEN_H - PADDLE_H - 2;
+    for (int i = 0; i < POWERUP_POOL_SIZE; ++i) {
+        powerup_handle_t handle = powerups_handle(pu, i);
+        powerup_t *p = powerups_get(pu, handle);
+        if (!p) {
+            continue;
+        }
+        p->y++;
+        bool caught = p->y + POWERUP_SIZE >= paddle_y && p->y < paddle_y + PADDLE_H &&
+                      p->x + POWERUP_SIZE > game->paddle.x && p->x < game->paddle.x + game->paddle.w;
+        if (caught) {
+            powerup_collect(game, (powerup_type_t)p->type);
+            powerups_release(pu, handle);
+        } else if (p->y >= SCREEN_H) {
+            powerups_release(pu, handle);
+        }
+    }
+}
+
+static void powerup_maybe_drop(game_t *game)
+{
+    if (!game->powerups_enabled || game->hits % POWERUP_EVERY_HITS != 0) {
+        return;
+    }
+    powerup_type_t type = (powerup_type_t)rng_range(&game->rng, POWERUP_TYPE_COUNT);
+    int x = rng_range(&game->rng, SCREEN_W - POWERUP_SIZE);
+    powerups_spawn(&game->powerups, type, x, POWERUP_DROP_Y);
+}
+
+static rect_t ball_rect(const ball_t *ball)
+{
+    return (rect_t) { FROM_SUBPX(ball->x), FROM_SUBPX(ball->y), BALL_SIZE, BALL_SIZE };
+}
+
+static void ball_bounce_obstacles(ball_t *ball, obstacle_field_t *field, int prev_x, int prev_y)
+{
+    rect_t now = ball_rect(ball);
+    rect_t prev = { FROM_SUBPX(prev_x), FROM_SUBPX(prev_y), BALL_SIZE, BALL_SIZE };
+
+    // Swept box covering the whole move, so fast balls cannot tunnel.
+    rect_t swept = prev;
+    if (now.x < swept.x) {
+        swept.w += swept.x - now.x;
+        swept.x = now.x;
+    } else {
+        swept.w += now.x - swept.x;
+    }
+    if (now.y < swept.y) {
+        swept.h += swept.y - now.y;
+        swept.y = now.y;
+    } else {
+        swept.h += now.y - swept.y;
+    }
+
+    int hit = obstacles_hit_grid(field, swept);
+    if (hit < 0) {
+        return;
+    }
+
+    // Reflect on the axis along which the ball was still clear of the obstacle.
+    const obstacle_t *o = &field->items[hit];
+    bool clear_x = prev.x + prev.w <= o->x || prev.x >= o->x + OBSTACLE_W;
+    if (clear_x) {
+        ball->vx = (prev.x < o->x) ? -abs(ball->vx) : abs(ball->vx);
+    } else {
+        ball->vy = (prev.y < o->y) ? -abs(ball->vy) : abs(ball->vy);
+    }
+    ball->x = prev_x;
+    ball->y = prev_y;
+
+    obstacles_damage(field, hit);
+}
+
+void game_reset(game_t *game, uint32_t seed)
+{
+    ball_t *ball = &game->ball;
+    paddle_t *paddle = &game->paddle;
+    const difficulty_t *level = difficulty_for_hits(0);
+    paddle->w = level->paddle_w;
+    paddle->x = SCREEN_W / 2 - paddle->w / 2;
+    ball->x = TO_SUBPX(SCREEN_W / 2);
+    ball->y = 0;
+    ball_set_direction(ball, level->speed, level->serve_dir, 1, 1);
+    game->hits = 0;
+    game->misses = 0;
+    game->bonus_lives = 0;
+    game->tick = 0;
+    game->rng = seed ? seed : 1;
+    powerups_clear(&game->powerups);
+}
+
+static void game_advance(game_t *game)
+{
+    ball_t *ball = &game->ball;
+    paddle_t *paddle = &game->paddle;
+
+    game->tick++;
+    powerups_step(game);
+    if (powerups_effect_active(&game->powerups, POWERUP_SLOW_BALL) && game->tick % SLOW_BALL_SKIP == 0) {
+        return;
+    }
+
+    int prev_x = ball->x;
+    int prev_y = ball->y;
+
+    ball->x += ball->vx;
+    ball->y += ball->vy;
+
+    if (game->obstacles) {
+        obstacles_update(game->obstacles);
+        ball_bounce_obstacles(ball, game->obstacles, prev_x, prev_y);
+    }
+
+    // Walls reflect and clamp, so the ball never ends a step outside the field.
+    if (ball->x <= 0) {
+        ball->x = 0;
+        ball->vx = abs(ball->vx);
+    } else if (ball->x + TO_SUBPX(BALL_SIZE) >= TO_SUBPX(SCREEN_W)) {
+        ball->x = TO_SUBPX(SCREEN_W - BALL_SIZE);
+        ball->vx = -abs(ball->vx);
+    }
+
+    if (ball->y <= 0) {
+        ball->y = 0;
+        ball->vy = abs(ball->vy);
+    }
+
+    int paddle_y = SCREEN_H - PADDLE_H - 2;
+    if (ball->y + TO_SUBPX(BALL_SIZE) >= TO_SUBPX(paddle_y)) {
+        int ball_x = FROM_SUBPX(ball->x);
+        if (ball_x + BALL_SIZE >= paddle->x && ball_x <= paddle->x + paddle->w) {
+            ball->y = TO_SUBPX(paddle_y - BALL_SIZE - 1);
+            game->hits++;
+            const difficulty_t *level = difficulty_for_hits(game->hits);
+            int segment = paddle_segment(paddle, ball_x + BALL_SIZE / 2);
+            ball_set_direction(ball, level->speed, k_paddle_dir[segment], k_paddle_sign[segment], -1);
+            paddle_update_width(game);
+            powerup_maybe_drop(game);
+        } else if (ball->y + TO_SUBPX(BALL_SIZE) >= TO_SUBPX(SCREEN_H)) {
+            game->misses++;
+            int sign_x = (ball->vx > 0) ? -1 : 1;
+            ball->x = TO_SUBPX(SCREEN_W / 2);
+            ball->y = 0;
+            const difficulty_t *level = difficulty_for_hits(game->hits);
+            // Serves always start at base speed, whatever the rally reached.
+            ball_set_direction(ball, difficulty_for_hits(0)->speed, level->serve_dir, sign_x, 1);
+        }
+    }
+}
+
+// Invariants every step has to keep, whatever the physics code looks like:
+// the ball stays inside the field and keeps moving, hits never go down and
+// at most one miss is counted per step, never more than there are lives.
+static void game_check_step(const game_t *before, const game_t *after)
+{
+    const ball_t *ball = &after->ball;
+    const char *broken = NULL;
+    if (ball->x < 0 || ball->x > TO_SUBPX(SCREEN_W - BALL_SIZE) ||
+        ball->y < 0 || ball->y > TO_SUBPX(SCREEN_H - BALL_SIZE)) {
+        broken = "ball left the field";
+    } else if (ball->vx == 0 && ball->vy == 0) {
+        broken = "ball stopped";
+    } else if (after->hits < before->hits) {
+        broken = "hit count went down";
+    } else if (after->misses < before->misses || after->misses > before->misses + 1) {
+        broken = "miss count jumped";
+    } else if (after->misses > MAX_LIVES + after->bonus_lives) {
+        broken = "more misses than lives";
+    }
+    if (!broken) {
+        return;
+    }
+    ESP_LOGE(TAG, "Physics check failed at tick %lu: %s (ball %d,%d v %d,%d, hits %d, misses %d)",
+             (unsigned long)after->tick, broken, ball->x, ball->y, ball->vx, ball->vy,
+             after->hits, after->misses);
+    abort();
+}
+
+void game_step(game_t *game)
+{
+    if (!ENABLE_PHYSICS_CHECKS) {
+        game_advance(game);
+        return;
+    }
+    game_t before = *game;
+    game_advance(game);
+    game_check_step(&before, game);
+}
+
+_Static_assert(sizeof(obstacle_t) == 10, "obstacles are hashed as bytes and must not have padding");
+
+uint32_t game_hash(const game_t *game, uint32_t h)
+{
+    h = state_hash_u32(h, (uint32_t)game->ball.x);
+    h = state_hash_u32(h, (uint32_t)game->ball.y);
+    h = state_hash_u32(h, (uint32_t)game->ball.vx);
+    h = state_hash_u32(h, (uint32_t)game->ball.vy);
+    h = state_hash_u32(h, (uint32_t)game->paddle.x);
+    h = state_hash_u32(h, (uint32_t)game->paddle.w);
+    h = state_hash_u32(h, (uint32_t)game->hits);
+    h = state_hash_u32(h, (uint32_t)game->misses);
+    h = state_hash_u32(h, (uint32_t)game->bonus_lives);
+    h = state_hash_u32(h, game->tick);
+    h = state_hash_u32(h, game->rng);
+
+    const powerups_t *pu = &game->powerups;
+    for (int i = 0; i < POWERUP_POOL_SIZE; ++i) {
+        const powerup_t *p = &pu->pool[i];
+        h = state_hash_u32(h, p->active ? 1 : 0);
+        if (p->active) {
+            h = state_hash_u32(h, (uint32_t)p->x);
+            h = state_hash_u32(h, (uint32_t)p->y);
+            h = state_hash_u32(h, p->type | (p->generation << 8));
+        }
+    }
+    for (int i = 0; i < pu->heap_len; ++i) {
+        h = state_hash_u32(h, pu->heap[i].expires);
+        h = state_hash_u32(h, pu->heap[i].type | (pu->heap[i].generation << 8));
+    }
+    h = state_hash_bytes(h, pu->effect_generation, sizeof(pu->effect_generation));
+    h = state_hash_bytes(h, pu->effect_active, sizeof(pu->effect_active));
+
+    if (game->obstacles) {
+        h = state_hash_u32(h, game->obstacles->count);
+        h = state_hash_bytes(h, game->obstacles->items, game->obstacles->count * sizeof(obstacle_t));
+    }
+    return h;
+}
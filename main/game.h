@@ -0,0 +1,59 @@
+#pragma once
+
+#include "game_config.h"
+#include "obstacles.h"
+#include "powerups.h"
+
+// Ball coordinates and velocities are kept in subpixels. Every entry of the
+// direction table has length BALL_DIR_ONE, so a ball at `speed` moves exactly
+// speed * BALL_DIR_ONE subpixels per step in any direction. The ratio
+// BALL_DIR_ONE / BALL_SUBPX (85 / 60) approximates sqrt(2), which keeps the
+// pace of the classic 45-degree diagonal.
+#define BALL_SUBPX 60
+#define BALL_DIR_ONE 85
+
+#define TO_SUBPX(px) ((px) * BALL_SUBPX)
+#define FROM_SUBPX(v) ((v) / BALL_SUBPX)
+
+// Number of zones across the paddle, each with its own bounce angle.
+#define PADDLE_SEGMENTS 8
+
+// Extra hearts from power-ups stack on top of MAX_LIVES up to this limit.
+#define MAX_BONUS_LIVES 3
+
+typedef struct {
+    int x;
+    int y;
+    int vx;
+    int vy;
+} ball_t;
+
+typedef struct {
+    int x;
+    int w;
+} paddle_t;
+
+typedef struct {
+    ball_t ball;
+    paddle_t paddle;
+    int hits;
+    int misses;
+    int bonus_lives;
+    uint32_t tick;
+    uint32_t rng;
+    bool powerups_enabled;
+    powerups_t powerups;
+    // Optional obstacle field; NULL plays classic Pong.
+    obstacle_field_t *obstacles;
+} game_t;
+
+void game_reset(game_t *game, uint32_t seed);
+void game_step(game_t *game);
+
+// Folds the simulation state into `h`; see state_hash.h.
+uint32_t game_hash(const game_t *game, uint32_t h);
+
+static inline int game_lives(const game_t *game)
+{
+    return MAX_LIVES + game->bonus_lives - game->misses;
+}
@@ -0,0 +1,186 @@
+#include "mini_game.h"
+
+#include <stdio.h>
+
+#include "display.h"
+#include "game_config.h"
+#include "rng.h"
+#include "state_hash.h"
+
+// Catch: blocks fall from the top, the paddle collects them. Every
+// CATCH_SPEEDUP_EVERY catches they fall a little faster and drop more often.
+#define CATCH_MAX_ITEMS 6
+#define CATCH_ITEM_SIZE 6
+#define CATCH_SUBPX 16
+#define CATCH_BASE_SPEED 16
+#define CATCH_SPEED_STEP 4
+#define CATCH_SPEEDUP_EVERY 5
+#define CATCH_SPAWN_STEPS 60
+#define CATCH_MIN_SPAWN_STEPS 20
+
+typedef struct {
+    int x;
+    int y;
+    bool active;
+} catch_item_t;
+
+typedef struct {
+    catch_item_t items[CATCH_MAX_ITEMS];
+    int paddle_x;
+    int paddle_w;
+    int caught;
+    int missed;
+    int spawn_timer;
+    uint32_t rng;
+    // Latched paddle, kept by the next tick; see pong_state_t.
+    bool paddle_latched;
+    int paddle_tick_x;
+} catch_state_t;
+
+static void *catch_init(arena_t *arena, uint32_t seed)
+{
+    catch_state_t *c = arena_alloc(arena, sizeof(*c));
+    if (!c) {
+        return NULL;
+    }
+    c->paddle_w = PADDLE_W;
+    c->paddle_x = SCREEN_W / 2 - c->paddle_w / 2;
+    c->rng = seed ? seed : 1;
+    return c;
+}
+
+static int catch_speed(const catch_state_t *c)
+{
+    return CATCH_BASE_SPEED + (c->caught / CATCH_SPEEDUP_EVERY) * CATCH_SPEED_STEP;
+}
+
+static int catch_spawn_interval(const catch_state_t *c)
+{
+    int steps = CATCH_SPAWN_STEPS - (c->caught / CATCH_SPEEDUP_EVERY) * 4;
+    return steps > CATCH_MIN_SPAWN_STEPS ? steps : CATCH_MIN_SPAWN_STEPS;
+}
+
+static void catch_spawn(catch_state_t *c)
+{
+    for (int i = 0; i < CATCH_MAX_ITEMS; ++i) {
+        if (!c->items[i].active) {
+            c->items[i] = (catch_item_t) {
+                .x = rng_range(&c->rng, SCREEN_W - CATCH_ITEM_SIZE),
+                .y = 0,
+                .active = true,
+            };
+            return;
+        }
+    }
+}
+
+static bool catch_tick(void *state, const game_input_t *input)
+{
+    catch_state_t *c = state;
+    if (c->paddle_latched) {
+        c->paddle_latched = false;
+    } else {
+        c->paddle_x = mini_game_paddle_x(c->paddle_x, c->paddle_w, SCREEN_W, input);
+    }
+
+    if (--c->spawn_timer <= 0) {
+        catch_spawn(c);
+        c->spawn_timer = catch_spawn_interval(c);
+    }
+
+    int paddle_y = SCREEN_H - PADDLE_H - 2;
+    int speed = catch_speed(c);
+    for (int i = 0; i < CATCH_MAX_ITEMS; ++i) {
+        catch_item_t *item = &c->items[i];
+        if (!item->active) {
+            continue;
+        }
+        item->y += speed;
+        int y = item->y / CATCH_SUBPX;
+        if (y + CATCH_ITEM_SIZE >= paddle_y && y <= paddle_y + PADDLE_H &&
+            item->x + CATCH_ITEM_SIZE >= c->paddle_x && item->x <= c->paddle_x + c->paddle_w) {
+            item->active = false;
+            c->caught++;
+        } else if (y >= SCREEN_H) {
+            item->active = false;
+            c->missed++;
+        }
+    }
+    return c->missed < MAX_LIVES;
+}
+
+static int catch_score(const void *state)
+{
+    return ((const catch_state_t *)state)->caught;
+}
+
+static void catch_render(void *state, const game_render_ctx_t *ctx)
+{
+    const catch_state_t *c = state;
+    for (int i = 0; i < CATCH_MAX_ITEMS; ++i) {
+        const catch_item_t *item = &c->items[i];
+        if (item->active) {
+            display_draw_rect(item->x, item->y / CATCH_SUBPX, CATCH_ITEM_SIZE, CATCH_ITEM_SIZE, COLOR_WHITE);
+        }
+    }
+    if (!ctx->late_paddle) {
+        display_draw_rect(c->paddle_x, SCREEN_H - PADDLE_H - 2, c->paddle_w, PADDLE_H, COLOR_WHITE);
+    }
+
+    char buf[32];
+    if (ctx->show_highscore) {
+        snprintf(buf, sizeof(buf), "HISCORE:%d C:%d", ctx->highscore, c->caught);
+    } else {
+        snprintf(buf, sizeof(buf), "C:%d", c->caught);
+    }
+    draw_text(UI_MARGIN, UI_MARGIN, buf, UI_SCALE);
+
+    int heart_w = 8 * UI_SCALE;
+    int heart_spacing = 2 * UI_SCALE;
+    int hearts_x = SCREEN_W - MAX_LIVES * (heart_w + heart_spacing);
+    for (int i = 0; i < MAX_LIVES; ++i) {
+        draw_heart(hearts_x + i * (heart_w + heart_spacing), UI_MARGIN, UI_SCALE, i < MAX_LIVES - c->missed);
+    }
+}
+
+static void catch_latch(void *state, const game_input_t *input)
+{
+    catch_state_t *c = state;
+    if (!c->paddle_latched) {
+        c->paddle_tick_x = c->paddle_x;
+        c->paddle_latched = true;
+    }
+    c->paddle_x = mini_game_paddle_x(c->paddle_tick_x, c->paddle_w, SCREEN_W, input);
+    display_draw_rect(c->paddle_x, SCREEN_H - PADDLE_H - 2, c->paddle_w, PADDLE_H, COLOR_WHITE);
+}
+
+static uint32_t catch_hash(const void *state)
+{
+    const catch_state_t *c = state;
+    uint32_t h = STATE_HASH_INIT;
+    for (int i = 0; i < CATCH_MAX_ITEMS; ++i) {
+        const catch_item_t *item = &c->items[i];
+        h = state_hash_u32(h, item->active ? 1 : 0);
+        if (item->active) {
+            h = state_hash_u32(h, (uint32_t)item->x);
+            h = state_hash_u32(h, (uint32_t)item->y);
+        }
+    }
+    h = state_hash_u32(h, (uint32_t)c->paddle_x);
+    h = state_hash_u32(h, (uint32_t)c->paddle_w);
+    h = state_hash_u32(h, (uint32_t)c->caught);
+    h = state_hash_u32(h, (uint32_t)c->missed);
+    h = state_hash_u32(h, (uint32_t)c->spawn_timer);
+    return state_hash_u32(h, c->rng);
+}
+
+const mini_game_t g_game_catch = {
+    .name = "Catch",
+    .highscore_key = "hs_catch",
+    .init = catch_init,
+    .tick = catch_tick,
+    .render = catch_render,
+    .score = catch_score,
+    .latch = catch_latch,
+    .hash = catch_hash,
+};
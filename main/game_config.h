@@ -0,0 +1,25 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+#define SCREEN_W CONFIG_PONG_SCREEN_WIDTH
+#define SCREEN_H CONFIG_PONG_SCREEN_HEIGHT
+
+// Rows held by the render buffer: the whole screen, or one strip on panels
+// too large for a full framebuffer.
+#ifdef CONFIG_PONG_STRIP_RENDER
+#define RENDER_ROWS CONFIG_PONG_STRIP_HEIGHT
+#else
+#define RENDER_ROWS SCREEN_H
+#endif
+
+#define PADDLE_H 4
+#define PADDLE_W (SCREEN_W / 5)
+#define PADDLE_MIN_W CONFIG_PONG_PADDLE_MIN_WIDTH
+#define BALL_SIZE CONFIG_PONG_BALL_SIZE
+
+#define BALL_BASE_SPEED 1
+#define BALL_SPEED_STEP_HITS 10
+#define BALL_SPEED_FACTOR 2
+#define BALL_MAX_SPEED 3
+#define MAX_LIVES 3
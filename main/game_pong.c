@@ -0,0 +1,242 @@
+#include "mini_game.h"
+
+#include <stdio.h>
+
+#include "display.h"
+#include "frame_governor.h"
+#include "game.h"
+#include "sdkconfig.h"
+#include "state_hash.h"
+
+#define BALL_TRAIL_LEN 3
+
+#ifdef CONFIG_PONG_OBSTACLE_MODE
+#define ENABLE_OBSTACLE_MODE 1
+#define OBSTACLE_COUNT CONFIG_PONG_OBSTACLE_COUNT
+#else
+#define ENABLE_OBSTACLE_MODE 0
+#define OBSTACLE_COUNT 0
+#endif
+
+#ifdef CONFIG_PONG_POWERUPS
+#define ENABLE_POWERUPS 1
+#else
+#define ENABLE_POWERUPS 0
+#endif
+
+typedef struct {
+    game_t game;
+    int trail_x[BALL_TRAIL_LEN];
+    int trail_y[BALL_TRAIL_LEN];
+    int trail_len;
+    // Set by pong_latch() until the next tick, which then keeps the latched
+    // paddle instead of moving it from paddle_tick_x again.
+    bool paddle_latched;
+    int paddle_tick_x;
+} pong_state_t;
+
+_Static_assert(sizeof(pong_state_t) + sizeof(obstacle_field_t) + 2 * ARENA_ALIGN <= GAME_ARENA_SIZE,
+               "obstacle Pong does not fit the game arena");
+
+static void *pong_setup(arena_t *arena, uint32_t seed, int obstacle_count)
+{
+    pong_state_t *pong = arena_alloc(arena, sizeof(*pong));
+    if (!pong) {
+        return NULL;
+    }
+    if (obstacle_count > 0) {
+        pong->game.obstacles = arena_alloc(arena, sizeof(obstacle_field_t));
+        if (!pong->game.obstacles) {
+            return NULL;
+        }
+    }
+    game_reset(&pong->game, seed);
+    pong->game.powerups_enabled = ENABLE_POWERUPS;
+    if (pong->game.obstacles) {
+        obstacles_generate(pong->game.obstacles, obstacle_count, seed ^ 0x9E3779B9u);
+    }
+    return pong;
+}
+
+static void *pong_init(arena_t *arena, uint32_t seed)
+{
+    return pong_setup(arena, seed, 0);
+}
+
+static void *obstacles_init(arena_t *arena, uint32_t seed)
+{
+    return pong_setup(arena, seed, OBSTACLE_COUNT);
+}
+
+static bool pong_tick(void *state, const game_input_t *input)
+{
+    pong_state_t *pong = state;
+    game_t *game = &pong->game;
+    if (pong->paddle_latched) {
+        pong->paddle_latched = false;
+    } else {
+        game->paddle.x = mini_game_paddle_x(game->paddle.x, game->paddle.w, SCREEN_W, input);
+    }
+    game_step(game);
+    return game_lives(game) > 0;
+}
+
+static int pong_score(const void *state)
+{
+    return ((const pong_state_t *)state)->game.hits;
+}
+
+static void render_ball_trail(pong_state_t *pong)
+{
+    int dot = BALL_SIZE / 2;
+    for (int i = 0; i < pong->trail_len; ++i) {
+        display_draw_rect(pong->trail_x[i] + dot / 2, pong->trail_y[i] + dot / 2, dot, dot, COLOR_WHITE);
+    }
+
+    for (int i = BALL_TRAIL_LEN - 1; i > 0; --i) {
+        pong->trail_x[i] = pong->trail_x[i - 1];
+        pong->trail_y[i] = pong->trail_y[i - 1];
+    }
+    pong->trail_x[0] = FROM_SUBPX(pong->game.ball.x);
+    pong->trail_y[0] = FROM_SUBPX(pong->game.ball.y);
+    if (pong->trail_len < BALL_TRAIL_LEN) {
+        pong->trail_len++;
+    }
+}
+
+static void render_obstacles(const obstacle_field_t *field)
+{
+    for (int i = 0; i < field->count; ++i) {
+        const obstacle_t *o = &field->items[i];
+        display_draw_rect(o->x, o->y, OBSTACLE_W, OBSTACLE_H, COLOR_WHITE);
+    }
+}
+
+static void render_powerups(const powerups_t *pu)
+{
+    for (int i = 0; i < POWERUP_POOL_SIZE; ++i) {
+        const powerup_t *p = &pu->pool[i];
+        if (!p->active) {
+            continue;
+        }
+        switch (p->type) {
+            case POWERUP_WIDE_PADDLE:
+                display_draw_rect(p->x, p->y + POWERUP_SIZE / 2 - 1, POWERUP_SIZE, 3, COLOR_WHITE);
+                break;
+            case POWERUP_SLOW_BALL:
+                display_draw_rect(p->x, p->y, POWERUP_SIZE, POWERUP_SIZE, COLOR_WHITE);
+                display_draw_rect(p->x + 2, p->y + 2, POWERUP_SIZE - 4, POWERUP_SIZE - 4, COLOR_BLACK);
+                break;
+            case POWERUP_EXTRA_HEART:
+                draw_heart(p->x, p->y, 1, true);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void pong_render(void *state, const game_render_ctx_t *ctx)
+{
+    pong_state_t *pong = state;
+    const game_t *game = &pong->game;
+    const ball_t *ball = &game->ball;
+    const paddle_t *paddle = &game->paddle;
+    int hits = game->hits;
+
+    if (ctx->flags & RENDER_EFFECTS) {
+        render_ball_trail(pong);
+    }
+
+    if (game->obstacles) {
+        render_obstacles(game->obstacles);
+    }
+    render_powerups(&game->powerups);
+
+    if (!ctx->late_paddle) {
+        display_draw_rect(paddle->x, SCREEN_H - PADDLE_H - 2, paddle->w, PADDLE_H, COLOR_WHITE);
+    }
+    display_draw_ball(FROM_SUBPX(ball->x), FROM_SUBPX(ball->y), COLOR_WHITE);
+
+    char buf[32];
+    if (ctx->show_highscore) {
+        snprintf(buf, sizeof(buf), "HISCORE:%d H:%d", ctx->highscore, hits);
+    } else {
+        snprintf(buf, sizeof(buf), "H:%d", hits);
+    }
+    int hud_scale = (ctx->show_highscore || !(ctx->flags & RENDER_HUD_FULL)) ? UI_SCALE : 2 * UI_SCALE;
+    draw_text(UI_MARGIN, UI_MARGIN, buf, hud_scale);
+
+    int hearts = MAX_LIVES + game->bonus_lives;
+    int lives = game_lives(game);
+    if (lives < 0) {
+        lives = 0;
+    }
+    int heart_scale = UI_SCALE;
+    int heart_w = 8 * heart_scale;
+    int heart_spacing = 2 * UI_SCALE;
+    int total_w = hearts * heart_w + (hearts - 1) * heart_spacing;
+    int hearts_x = SCREEN_W - total_w - UI_MARGIN;
+    int hearts_y = UI_MARGIN;
+    for (int i = 0; i < hearts; ++i) {
+        draw_heart(hearts_x + i * (heart_w + heart_spacing), hearts_y, heart_scale, i < lives);
+    }
+}
+
+static void pong_latch(void *state, const game_input_t *input)
+{
+    pong_state_t *pong = state;
+    paddle_t *paddle = &pong->game.paddle;
+    // Frames without a step latch again from where the last tick left it.
+    if (!pong->paddle_latched) {
+        pong->paddle_tick_x = paddle->x;
+        pong->paddle_latched = true;
+    }
+    paddle->x = mini_game_paddle_x(pong->paddle_tick_x, paddle->w, SCREEN_W, input);
+    display_draw_rect(paddle->x, SCREEN_H - PADDLE_H - 2, paddle->w, PADDLE_H, COLOR_WHITE);
+}
+
+// The trail is drawing state and left out.
+static uint32_t pong_hash(const void *state)
+{
+    const pong_state_t *pong = state;
+    return game_hash(&pong->game, STATE_HASH_INIT);
+}
+
+// The obstacle grid sits at the end of the arena and is derived from the
+// obstacles, so rewind leaves it out and rebuilds it.
+static size_t obstacles_snapshot_size(const void *state)
+{
+    const pong_state_t *pong = state;
+    return (size_t)((const uint8_t *)pong->game.obstacles->cell_start - (const uint8_t *)pong);
+}
+
+static void obstacles_rewound(void *state)
+{
+    pong_state_t *pong = state;
+    obstacles_rebuild_grid(pong->game.obstacles);
+}
+
+const mini_game_t g_game_pong = {
+    .name = "Pong",
+    .highscore_key = "highscore",
+    .init = pong_init,
+    .tick = pong_tick,
+    .render = pong_render,
+    .score = pong_score,
+    .latch = pong_latch,
+    .hash = pong_hash,
+};
+
+const mini_game_t g_game_obstacles = {
+    .name = "Bricks",
+    .highscore_key = "hs_bricks",
+    .init = obstacles_init,
+    .tick = pong_tick,
+    .render = pong_render,
+    .score = pong_score,
+    .latch = pong_latch,
+    .snapshot_size = obstacles_snapshot_size,
+    .rewound = obstacles_rewound,
+    .hash = pong_hash,
+};
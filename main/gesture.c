@@ -0,0 +1,122 @@
+#include "gesture.h"
+
+#include <string.h>
+
+void gesture_init(gesture_engine_t *engine, const gesture_def_t *defs, int count)
+{
+    if (count > GESTURE_MAX) {
+        count = GESTURE_MAX;
+    }
+    memset(engine, 0, sizeof(*engine));
+    portMUX_INITIALIZE(&engine->lock);
+    engine->defs = defs;
+    engine->count = count;
+    for (int id = 0; id < count; ++id) {
+        const gesture_def_t *def = &defs[id];
+        if (def->kind == GESTURE_HOLD) {
+            for (uint32_t mask = def->buttons; mask; mask &= mask - 1) {
+                engine->starts[__builtin_ctz(mask)] |= 1u << id;
+            }
+        } else if (def->step_count > 0) {
+            engine->starts[def->steps[0]] |= 1u << id;
+        }
+    }
+}
+
+void gesture_update(gesture_engine_t *engine, uint32_t buttons, int64_t now_us)
+{
+    uint32_t pressed = buttons & ~engine->buttons;
+    uint32_t released = engine->buttons & ~buttons;
+    engine->buttons = buttons;
+    if (!pressed && !released && !engine->armed) {
+        return;
+    }
+
+    // Only gestures already in progress, plus those the new presses can
+    // start, plus completed holds on a release, need to be looked at.
+    uint32_t candidates = engine->armed;
+    for (uint32_t mask = pressed; mask; mask &= mask - 1) {
+        candidates |= engine->starts[__builtin_ctz(mask)];
+    }
+    uint32_t active = engine->active;
+    if (released) {
+        candidates |= active;
+    }
+
+    uint32_t fired = 0;
+    while (candidates) {
+        int id = __builtin_ctz(candidates);
+        uint32_t bit = 1u << id;
+        candidates &= candidates - 1;
+        const gesture_def_t *def = &engine->defs[id];
+
+        if (def->kind == GESTURE_HOLD) {
+            if ((buttons & def->buttons) != def->buttons) {
+                engine->armed &= ~bit;
+                active &= ~bit;
+                continue;
+            }
+            if (!(engine->armed & bit)) {
+                // Starts when the press that completes the chord arrives,
+                // not when it is already held after firing.
+                if (!(pressed & def->buttons)) {
+                    continue;
+                }
+                engine->armed |= bit;
+                engine->since_us[id] = now_us;
+            }
+            if (now_us - engine->since_us[id] >= (int64_t)def->hold_ms * 1000) {
+                engine->armed &= ~bit;
+                active |= bit;
+                fired |= bit;
+            }
+            continue;
+        }
+
+        if ((engine->armed & bit) && now_us - engine->since_us[id] > (int64_t)def->gap_ms * 1000) {
+            engine->armed &= ~bit;
+        }
+        for (uint32_t mask = pressed; mask; mask &= mask - 1) {
+            int button = __builtin_ctz(mask);
+            if ((engine->armed & bit) && def->steps[engine->step[id]] == button) {
+                engine->step[id]++;
+            } else if (def->steps[0] == button) {
+                engine->armed |= bit;
+                engine->step[id] = 1;
+            } else {
+                engine->armed &= ~bit;
+                continue;
+            }
+            engine->since_us[id] = now_us;
+            if (engine->step[id] >= def->step_count) {
+                engine->armed &= ~bit;
+                fired |= bit;
+            }
+        }
+    }
+
+    if (fired || active != engine->active) {
+        portENTER_CRITICAL(&engine->lock);
+        engine->fired |= fired;
+        engine->active = active;
+        portEXIT_CRITICAL(&engine->lock);
+    }
+}
+
+bool gesture_take(gesture_engine_t *engine, int id)
+{
+    uint32_t bit = 1u << id;
+    portENTER_CRITICAL(&engine->lock);
+    bool fired = (engine->fired & bit) != 0;
+    engine->fired &= ~bit;
+    portEXIT_CRITICAL(&engine->lock);
+    return fired;
+}
+
+bool gesture_active(gesture_engine_t *engine, int id)
+{
+    portENTER_CRITICAL(&engine->lock);
+    bool active = (engine->active & (1u << id)) != 0;
+    portEXIT_CRITICAL(&engine->lock);
+    return active;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+
+#define GESTURE_MAX 32
+#define GESTURE_SEQ_MAX 4
+
+typedef enum {
+    // All buttons in the mask held together for hold_ms. A single-button
+    // mask is a long press; hold_ms 0 fires as soon as the chord forms.
+    GESTURE_HOLD,
+    // Presses of the listed buttons in order, each within gap_ms of the
+    // previous one. A double tap is a two-step sequence of the same button.
+    GESTURE_SEQUENCE,
+} gesture_kind_t;
+
+typedef struct {
+    gesture_kind_t kind;
+    uint32_t buttons;
+    uint8_t steps[GESTURE_SEQ_MAX];
+    uint8_t step_count;
+    uint16_t hold_ms;
+    uint16_t gap_ms;
+} gesture_def_t;
+
+#define GESTURE_CHORD(mask, ms) \
+    { .kind = GESTURE_HOLD, .buttons = (mask), .hold_ms = (ms) }
+#define GESTURE_LONG_PRESS(button, ms) \
+    { .kind = GESTURE_HOLD, .buttons = 1u << (button), .hold_ms = (ms) }
+#define GESTURE_DOUBLE_TAP(button, gap) \
+    { .kind = GESTURE_SEQUENCE, .steps = { (button), (button) }, .step_count = 2, .gap_ms = (gap) }
+#define GESTURE_SEQ(gap, ...)                                                   \
+    { .kind = GESTURE_SEQUENCE, .steps = { __VA_ARGS__ },                      \
+      .step_count = sizeof((uint8_t[]) { __VA_ARGS__ }), .gap_ms = (gap) }
+
+typedef struct {
+    const gesture_def_t *defs;
+    int count;
+    // Gestures a press of each button can start, by button index.
+    uint32_t starts[32];
+    uint32_t buttons;
+    // Gestures in progress; only these are looked at between edges.
+    uint32_t armed;
+    uint8_t step[GESTURE_MAX];
+    int64_t since_us[GESTURE_MAX];
+    // Published to the consumer under lock.
+    portMUX_TYPE lock;
+    uint32_t fired;
+    uint32_t active;
+} gesture_engine_t;
+
+// The table must outlive the engine. Gesture ids are table indices.
+void gesture_init(gesture_engine_t *engine, const gesture_def_t *defs, int count);
+
+// Feeds the current button state (one bit per button). Costs O(gestures in
+// progress); idle calls without edges return immediately.
+void gesture_update(gesture_engine_t *engine, uint32_t buttons, int64_t now_us);
+
+// Returns true once each time the gesture completes.
+bool gesture_take(gesture_engine_t *engine, int id);
+
+// True while a hold gesture is completed and still held.
+bool gesture_active(gesture_engine_t *engine, int id);
@@ -0,0 +1,223 @@
+#include "input_sampler.h"
+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
+#include "wake.h"
+#include "sdkconfig.h"
+
+#define TAG "input"
+
+#define STATS_PERIOD_US (10 * 1000 * 1000)
+
+// The vertical counter confirms a change on the fourth equal sample, so the
+// physical edge happened three sample periods before it is published.
+#define DEBOUNCE_DELAY_US (3 * INPUT_SAMPLE_PERIOD_US)
+
+static esp_timer_handle_t s_timer = NULL;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int s_gpio[INPUT_BUTTON_COUNT];
+static uint64_t s_pin_mask;
+
+// Vertical counter: bit n of ct0/ct1 is a 2-bit counter for GPIO n. A pin only
+// flips in s_debounced after it differed from it for four samples in a row.
+static uint64_t s_debounced;
+static uint64_t s_ct0;
+static uint64_t s_ct1;
+
+// Published state, guarded by s_lock. Buttons pressed through GPIO and
+// through injected sources (touch pads) are merged into s_buttons.
+static uint32_t s_gpio_buttons;
+static uint32_t s_injected_buttons;
+static uint32_t s_buttons;
+static uint32_t s_press_pending;
+static uint32_t s_press_injected;
+static int64_t s_pressed_at[INPUT_BUTTON_COUNT];
+
+static gesture_engine_t *volatile s_gestures;
+
+// Press-to-consume latency, split by source.
+static int64_t s_latency_sum[INPUT_SOURCE_COUNT];
+static uint32_t s_latency_count[INPUT_SOURCE_COUNT];
+
+static uint32_t s_cycles_total;
+static uint32_t s_cycles_max;
+static uint32_t s_samples;
+static int64_t s_stats_since;
+
+uint64_t input_read_gpio_levels(void)
+{
+    uint32_t low = REG_READ(GPIO_IN_REG);
+    uint32_t high = REG_READ(GPIO_IN1_REG) & 0xFF;
+    return ((uint64_t)high << 32) | low;
+}
+
+static void sampler_report(int64_t now)
+{
+    if (s_samples == 0) {
+        return;
+    }
+    uint32_t avg = s_cycles_total / s_samples;
+    // cycles per sample * samples per second / cycles per second
+    uint32_t permille = avg * (1000000 / INPUT_SAMPLE_PERIOD_US) / (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000);
+    ESP_LOGI(TAG, "Sampler: %lu samples, avg %lu / max %lu cycles, ~%lu.%lu%% CPU",
+             (unsigned long)s_samples, (unsigned long)avg, (unsigned long)s_cycles_max,
+             (unsigned long)(permille / 10), (unsigned long)(permille % 10));
+
+    static const char *const source_names[INPUT_SOURCE_COUNT] = { "gpio", "touch" };
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < INPUT_SOURCE_COUNT; ++i) {
+        if (s_latency_count[i] > 0) {
+            ESP_LOGI(TAG, "Press latency (%s): avg %lld us over %lu presses", source_names[i],
+                     (long long)(s_latency_sum[i] / s_latency_count[i]), (unsigned long)s_latency_count[i]);
+        }
+        s_latency_sum[i] = 0;
+        s_latency_count[i] = 0;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    s_cycles_total = 0;
+    s_cycles_max = 0;
+    s_samples = 0;
+    s_stats_since = now;
+}
+
+static void sampler_tick(void *arg)
+{
+    uint32_t start = esp_cpu_get_cycle_count();
+    int64_t now = esp_timer_get_time();
+
+    uint64_t raw = input_read_gpio_levels() & s_pin_mask;
+    uint64_t changed = raw ^ s_debounced;
+    s_ct0 = ~(s_ct0 & changed);
+    s_ct1 = s_ct0 ^ (s_ct1 & changed);
+    changed &= s_ct0 & s_ct1;
+    s_debounced ^= changed;
+
+    if (changed) {
+        // Buttons are active low.
+        uint32_t buttons = 0;
+        uint32_t pressed = 0;
+        for (int i = 0; i < INPUT_BUTTON_COUNT; ++i) {
+            if (s_gpio[i] < 0) {
+                continue;
+            }
+            uint64_t bit = 1ULL << s_gpio[i];
+            if (!(s_debounced & bit)) {
+                buttons |= 1u << i;
+                if (changed & bit) {
+                    pressed |= 1u << i;
+                }
+            }
+        }
+        portENTER_CRITICAL(&s_lock);
+        s_gpio_buttons = buttons;
+        pressed &= ~s_buttons;
+        s_buttons = s_gpio_buttons | s_injected_buttons;
+        s_press_pending |= pressed;
+        s_press_injected &= ~pressed;
+        for (int i = 0; i < INPUT_BUTTON_COUNT; ++i) {
+            if (pressed & (1u << i)) {
+                s_pressed_at[i] = now - DEBOUNCE_DELAY_US;
+            }
+        }
+        portEXIT_CRITICAL(&s_lock);
+        wake_post(WAKE_INPUT);
+    }
+
+    gesture_engine_t *gestures = s_gestures;
+    if (gestures) {
+        gesture_update(gestures, input_sampler_buttons(), now);
+    }
+
+    uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    s_cycles_total += cycles;
+    if (cycles > s_cycles_max) {
+        s_cycles_max = cycles;
+    }
+    s_samples++;
+    if (now - s_stats_since >= STATS_PERIOD_US) {
+        sampler_report(now);
+    }
+}
+
+esp_err_t input_sampler_start(const int gpio[INPUT_BUTTON_COUNT])
+{
+    s_pin_mask = 0;
+    for (int i = 0; i < INPUT_BUTTON_COUNT; ++i) {
+        s_gpio[i] = gpio[i];
+        if (gpio[i] >= 0) {
+            s_pin_mask |= 1ULL << gpio[i];
+        }
+    }
+    s_debounced = input_read_gpio_levels() & s_pin_mask;
+    s_ct0 = ~0ULL;
+    s_ct1 = ~0ULL;
+    s_stats_since = esp_timer_get_time();
+
+    const esp_timer_create_args_t args = {
+        .callback = sampler_tick,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "input",
+        .skip_unhandled_events = true,
+    };
+    esp_err_t err = esp_timer_create(&args, &s_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return esp_timer_start_periodic(s_timer, INPUT_SAMPLE_PERIOD_US);
+}
+
+void input_sampler_set_gestures(gesture_engine_t *engine)
+{
+    s_gestures = engine;
+}
+
+uint32_t input_sampler_buttons(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    uint32_t buttons = s_buttons;
+    portEXIT_CRITICAL(&s_lock);
+    return buttons;
+}
+
+bool input_sampler_take_press(input_button_t button, int64_t *at_us)
+{
+    uint32_t bit = 1u << button;
+    int64_t now = esp_timer_get_time();
+    bool pending;
+    portENTER_CRITICAL(&s_lock);
+    pending = (s_press_pending & bit) != 0;
+    if (pending) {
+        s_press_pending &= ~bit;
+        *at_us = s_pressed_at[button];
+        int source = (s_press_injected & bit) ? INPUT_SOURCE_INJECTED : INPUT_SOURCE_GPIO;
+        s_latency_sum[source] += now - s_pressed_at[button];
+        s_latency_count[source]++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return pending;
+}
+
+void IRAM_ATTR input_sampler_inject(input_button_t button, bool pressed, int64_t at_us)
+{
+    uint32_t bit = 1u << button;
+    portENTER_CRITICAL_SAFE(&s_lock);
+    if (pressed) {
+        s_injected_buttons |= bit;
+        if (!(s_buttons & bit)) {
+            s_press_pending |= bit;
+            s_press_injected |= bit;
+            s_pressed_at[button] = at_us;
+        }
+    } else {
+        s_injected_buttons &= ~bit;
+    }
+    s_buttons = s_gpio_buttons | s_injected_buttons;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+    wake_post(WAKE_INPUT);
+}
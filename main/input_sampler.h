@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "gesture.h"
+
+#define INPUT_SAMPLE_PERIOD_US 1000
+
+typedef enum {
+    INPUT_LEFT,
+    INPUT_RIGHT,
+    INPUT_PAUSE,
+    INPUT_BUTTON_COUNT
+} input_button_t;
+
+typedef enum {
+    INPUT_SOURCE_GPIO,
+    INPUT_SOURCE_INJECTED,
+    INPUT_SOURCE_COUNT
+} input_source_t;
+
+// Reads GPIO0-39 with two register loads (GPIO_IN and GPIO_IN1).
+uint64_t input_read_gpio_levels(void);
+
+// Starts sampling the given GPIOs (active low, -1 = unused) every
+// INPUT_SAMPLE_PERIOD_US. Debouncing needs four stable samples.
+esp_err_t input_sampler_start(const int gpio[INPUT_BUTTON_COUNT]);
+
+// Debounced state, one bit per input_button_t, set while pressed.
+uint32_t input_sampler_buttons(void);
+
+// Returns true once per press edge and reports when it was debounced.
+bool input_sampler_take_press(input_button_t button, int64_t *at_us);
+
+// Feeds a button from another source (e.g. a touch pad) into the same
+// state and press edges as the GPIO buttons. Safe to call from an ISR.
+void input_sampler_inject(input_button_t button, bool pressed, int64_t at_us);
+
+// Evaluates the gesture engine on every sample, so hold and tap timings are
+// measured to the millisecond instead of per frame. NULL detaches it.
+void input_sampler_set_gestures(gesture_engine_t *engine);
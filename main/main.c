@@ -1,213 +1,176 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
-#include "driver/spi_master.h"
-#include "esp_heap_caps.h"
-#include "esp_lcd_panel_io.h"
-#include "esp_lcd_panel_ops.h"
-#include "esp_lcd_panel_vendor.h"
+#include "esp_timer.h"
 #include "esp_log.h"
+#include "esp_random.h"
 #include "nvs.h"
 #include "nvs_flash.h"
 #include "sdkconfig.h"
-#include <string.h>
+#include "analog_paddle.h"
+#include "arena.h"
+#include "bench.h"
+#include "deadline.h"
+#include "difficulty.h"
+#include "display.h"
+#include "frame_governor.h"
+#include "gesture.h"
+#include "input_sampler.h"
+#include "mini_game.h"
+#include "rewind.h"
+#include "start_screen.h"
+#include "state_hash.h"
+#include "touch_paddle.h"
+#include "transition.h"
+#include "tuning.h"
+#include "wake.h"
 #include <stdio.h>
 
 #define TAG "pong"
 
-// LCD pins (as provided)
-#define LCD_MOSI 23
-#define LCD_SCLK 18
-#define LCD_CS   15
-#define LCD_DC    2
-#define LCD_RST   CONFIG_PONG_LCD_RST_GPIO
-#define LCD_BLK  32
+// Simulation runs at a fixed rate; render + flush should fit in the budget.
+#define SIM_TICK_US (16 * 1000)
+#define FRAME_BUDGET_US (14 * 1000)
 
-#define LCD_HOST SPI2_HOST
+#define GPIO_LEFT  CONFIG_PONG_GPIO_LEFT
+#define GPIO_RIGHT CONFIG_PONG_GPIO_RIGHT
+#define GPIO_PAUSE CONFIG_PONG_GPIO_PAUSE
 
-#define SCREEN_W CONFIG_PONG_SCREEN_WIDTH
-#define SCREEN_H CONFIG_PONG_SCREEN_HEIGHT
+#define ENABLE_GPIO_SCANNER 0
 
-#define PADDLE_H 4
-#define PADDLE_W (SCREEN_W / 5)
-#define BALL_SIZE CONFIG_PONG_BALL_SIZE
+#ifdef CONFIG_PONG_INPUT_SAMPLER
+#define ENABLE_INPUT_SAMPLER 1
+#else
+#define ENABLE_INPUT_SAMPLER 0
+#endif
 
-#define BALL_BASE_SPEED 1
-#define BALL_SPEED_STEP_HITS 10
-#define BALL_SPEED_FACTOR 2
-#define BALL_MAX_SPEED 3
-#define MAX_LIVES 3
+#ifdef CONFIG_PONG_TUNING_CONSOLE
+#define ENABLE_TUNING_CONSOLE 1
+#else
+#define ENABLE_TUNING_CONSOLE 0
+#endif
 
-#define GPIO_LEFT  CONFIG_PONG_GPIO_LEFT
-#define GPIO_RIGHT CONFIG_PONG_GPIO_RIGHT
-#define GPIO_PAUSE CONFIG_PONG_GPIO_PAUSE
+#ifdef CONFIG_PONG_BENCH
+#define ENABLE_BENCH 1
+#else
+#define ENABLE_BENCH 0
+#endif
 
-#define LCD_OFFSET_X CONFIG_PONG_LCD_OFFSET_X
-#define LCD_OFFSET_Y CONFIG_PONG_LCD_OFFSET_Y
+#ifdef CONFIG_PONG_DEADLINE_MONITOR
+#define ENABLE_DEADLINE_MONITOR 1
+#else
+#define ENABLE_DEADLINE_MONITOR 0
+#endif
 
-#define ENABLE_GPIO_SCANNER 0
+#ifdef CONFIG_PONG_TOUCH_PADDLE
+#define ENABLE_TOUCH_PADDLE 1
+#else
+#define ENABLE_TOUCH_PADDLE 0
+#endif
 
-#ifdef CONFIG_PONG_LCD_SWAP_XY
-#define LCD_SWAP_XY true
+#ifdef CONFIG_PONG_ANALOG_PADDLE
+#define ENABLE_ANALOG_PADDLE 1
 #else
-#define LCD_SWAP_XY false
+#define ENABLE_ANALOG_PADDLE 0
 #endif
 
-#ifdef CONFIG_PONG_LCD_MIRROR_X
-#define LCD_MIRROR_X true
+#ifdef CONFIG_PONG_OBSTACLE_MODE
+#define ENABLE_OBSTACLE_MODE 1
 #else
-#define LCD_MIRROR_X false
+#define ENABLE_OBSTACLE_MODE 0
 #endif
 
-#ifdef CONFIG_PONG_LCD_MIRROR_Y
-#define LCD_MIRROR_Y true
+#ifdef CONFIG_PONG_TRANSITIONS
+#define ENABLE_TRANSITIONS 1
+#define TRANSITION_US (CONFIG_PONG_TRANSITION_MS * 1000)
 #else
-#define LCD_MIRROR_Y false
+#define ENABLE_TRANSITIONS 0
+#define TRANSITION_US 0
 #endif
 
-#define COLOR_BLACK 0x0000
-#define COLOR_WHITE 0xFFFF
+#ifdef CONFIG_PONG_LATE_LATCH
+#define ENABLE_LATE_LATCH 1
+#else
+#define ENABLE_LATE_LATCH 0
+#endif
 
-typedef struct {
-    int x;
-    int y;
-    int vx;
-    int vy;
-} ball_t;
+#ifdef CONFIG_PONG_REWIND
+#define ENABLE_REWIND 1
+#else
+#define ENABLE_REWIND 0
+#endif
 
-typedef struct {
-    int x;
-} paddle_t;
+#ifdef CONFIG_PONG_STATE_HASH
+#define ENABLE_STATE_HASH 1
+#define STATE_HASH_SEED CONFIG_PONG_STATE_HASH_SEED
+#else
+#define ENABLE_STATE_HASH 0
+#define STATE_HASH_SEED 0
+#endif
+
+#ifdef CONFIG_PONG_STATE_HASH_SCRIPT
+#define ENABLE_STATE_HASH_SCRIPT 1
+#else
+#define ENABLE_STATE_HASH_SCRIPT 0
+#endif
+
+#ifdef CONFIG_PONG_STATS_OVERLAY
+#define ENABLE_STATS_OVERLAY 1
+#else
+#define ENABLE_STATS_OVERLAY 0
+#endif
 
 typedef struct {
     int gpio;
+    input_button_t id;
     int stable_level;
     int last_level;
     int stable_count;
-    TickType_t pressed_since;
 } button_t;
 
+typedef enum {
+    GESTURE_RESET_HIGHSCORE,
+    GESTURE_SHOW_HIGHSCORE_LEFT,
+    GESTURE_SHOW_HIGHSCORE_RIGHT,
+    GESTURE_QUIT,
+    GESTURE_REWIND,
+    GESTURE_COUNT
+} pong_gesture_t;
+
+// Hold left+right for three seconds on the start screen to reset the
+// highscore; long-press either button in game to show it; hold BOOT to
+// leave the game for the launcher. With rewind, holding left+right in game
+// runs it backwards.
+static const gesture_def_t k_gestures[GESTURE_COUNT] = {
+    [GESTURE_RESET_HIGHSCORE] = GESTURE_CHORD((1u << INPUT_LEFT) | (1u << INPUT_RIGHT), 3000),
+    [GESTURE_SHOW_HIGHSCORE_LEFT] = GESTURE_LONG_PRESS(INPUT_LEFT, 800),
+    [GESTURE_SHOW_HIGHSCORE_RIGHT] = GESTURE_LONG_PRESS(INPUT_RIGHT, 800),
+    [GESTURE_QUIT] = GESTURE_LONG_PRESS(INPUT_PAUSE, 1500),
+    [GESTURE_REWIND] = GESTURE_CHORD((1u << INPUT_LEFT) | (1u << INPUT_RIGHT), 300),
+};
+
+// Games offered by the launcher, in selection order.
+static const mini_game_t *const k_games[] = {
+    &g_game_pong,
+#if ENABLE_OBSTACLE_MODE
+    &g_game_obstacles,
+#endif
+    &g_game_catch,
+};
+
+#define GAME_COUNT ((int)(sizeof(k_games) / sizeof(k_games[0])))
+
 typedef enum {
     STATE_START,
     STATE_RUN,
     STATE_PAUSE
 } game_state_t;
 
-static esp_lcd_panel_handle_t s_panel = NULL;
-static uint16_t *s_framebuffer = NULL;
-
-static void display_clear(uint16_t color);
-static void display_flush(void);
 static void gpio_scanner_run(void);
 
-static void display_init(void)
+static void button_isr(void *arg)
 {
-    ESP_LOGI(TAG, "Display init (ST7789)");
-
-    gpio_config_t bk_conf = {
-        .pin_bit_mask = 1ULL << LCD_BLK,
-        .mode = GPIO_MODE_OUTPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE
-    };
-    gpio_config(&bk_conf);
-    gpio_set_level(LCD_BLK, 1);
-
-    spi_bus_config_t buscfg = {
-        .sclk_io_num = LCD_SCLK,
-        .mosi_io_num = LCD_MOSI,
-        .miso_io_num = -1,
-        .quadwp_io_num = -1,
-        .quadhd_io_num = -1,
-        .max_transfer_sz = SCREEN_W * SCREEN_H * 2 + 8,
-    };
-    ESP_ERROR_CHECK(spi_bus_initialize(LCD_HOST, &buscfg, SPI_DMA_CH_AUTO));
-
-    esp_lcd_panel_io_handle_t io_handle = NULL;
-    esp_lcd_panel_io_spi_config_t io_config = {
-        .dc_gpio_num = LCD_DC,
-        .cs_gpio_num = LCD_CS,
-        .pclk_hz = 40 * 1000 * 1000,
-        .lcd_cmd_bits = 8,
-        .lcd_param_bits = 8,
-        .spi_mode = 0,
-        .trans_queue_depth = 10,
-    };
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)LCD_HOST, &io_config, &io_handle));
-
-    esp_lcd_panel_dev_config_t panel_config = {
-        .reset_gpio_num = LCD_RST,
-        .color_space = ESP_LCD_COLOR_SPACE_RGB,
-        .bits_per_pixel = 16,
-    };
-    ESP_ERROR_CHECK(esp_lcd_new_panel_st7789(io_handle, &panel_config, &s_panel));
-
-    ESP_ERROR_CHECK(esp_lcd_panel_reset(s_panel));
-    ESP_ERROR_CHECK(esp_lcd_panel_init(s_panel));
-    ESP_ERROR_CHECK(esp_lcd_panel_mirror(s_panel, LCD_MIRROR_X, LCD_MIRROR_Y));
-    ESP_ERROR_CHECK(esp_lcd_panel_swap_xy(s_panel, LCD_SWAP_XY));
-    ESP_ERROR_CHECK(esp_lcd_panel_set_gap(s_panel, LCD_OFFSET_X, LCD_OFFSET_Y));
-    ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(s_panel, true));
-
-    size_t fb_size = SCREEN_W * SCREEN_H * sizeof(uint16_t);
-    s_framebuffer = heap_caps_malloc(fb_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
-    if (!s_framebuffer) {
-        ESP_LOGE(TAG, "Framebuffer allocation failed");
-        return;
-    }
-
-    display_clear(COLOR_BLACK);
-    display_flush();
-}
-
-static void display_clear(uint16_t color)
-{
-    if (!s_framebuffer) {
-        return;
-    }
-    for (int i = 0; i < SCREEN_W * SCREEN_H; ++i) {
-        s_framebuffer[i] = color;
-    }
-}
-
-static void display_draw_rect(int x, int y, int w, int h, uint16_t color)
-{
-    if (!s_framebuffer) {
-        return;
-    }
-    if (x < 0) {
-        w += x;
-        x = 0;
-    }
-    if (y < 0) {
-        h += y;
-        y = 0;
-    }
-    if (x + w > SCREEN_W) {
-        w = SCREEN_W - x;
-    }
-    if (y + h > SCREEN_H) {
-        h = SCREEN_H - y;
-    }
-    if (w <= 0 || h <= 0) {
-        return;
-    }
-
-    for (int yy = y; yy < y + h; ++yy) {
-        uint16_t *row = s_framebuffer + yy * SCREEN_W + x;
-        for (int xx = 0; xx < w; ++xx) {
-            row[xx] = color;
-        }
-    }
-}
-
-static void display_flush(void)
-{
-    if (!s_panel || !s_framebuffer) {
-        return;
-    }
-    ESP_ERROR_CHECK(esp_lcd_panel_draw_bitmap(s_panel, 0, 0, SCREEN_W, SCREEN_H, s_framebuffer));
+    wake_post(WAKE_INPUT);
 }
 
 static void buttons_init(void)
@@ -226,8 +189,9 @@ static void buttons_init(void)
         return;
     }
 
+    // Edges wake the game loop; the sampler reports its own when enabled.
     gpio_config_t io_conf = {
-        .intr_type = GPIO_INTR_DISABLE,
+        .intr_type = ENABLE_INPUT_SAMPLER ? GPIO_INTR_DISABLE : GPIO_INTR_ANYEDGE,
         .mode = GPIO_MODE_INPUT,
         .pin_bit_mask = mask,
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
@@ -235,6 +199,13 @@ static void buttons_init(void)
     };
 
     gpio_config(&io_conf);
+    if (!ENABLE_INPUT_SAMPLER && gpio_install_isr_service(0) == ESP_OK) {
+        for (int gpio = 0; gpio < 64; ++gpio) {
+            if (mask & (1ULL << gpio)) {
+                gpio_isr_handler_add(gpio, button_isr, NULL);
+            }
+        }
+    }
 }
 
 static bool gpio_is_unsafe_for_scan(int gpio)
@@ -300,11 +271,7 @@ static void gpio_scanner_run(void)
 {
     ESP_LOGI(TAG, "GPIO scanner: press a button to see the GPIO number");
 
-    int last_level[40];
-    for (int i = 0; i < 40; ++i) {
-        last_level[i] = 1;
-    }
-
+    uint64_t scan_mask = 0;
     for (int gpio = 0; gpio < 40; ++gpio) {
         if (!gpio_is_valid_esp32(gpio) || gpio_is_unsafe_for_scan(gpio)) {
             continue;
@@ -317,219 +284,35 @@ static void gpio_scanner_run(void)
             .pull_up_en = gpio_supports_pullup(gpio) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE
         };
         gpio_config(&io_conf);
-        last_level[gpio] = gpio_get_level(gpio);
+        scan_mask |= 1ULL << gpio;
     }
 
+    // One read of the input registers covers every pin.
+    uint64_t last_levels = input_read_gpio_levels() & scan_mask;
     while (true) {
-        for (int gpio = 0; gpio < 40; ++gpio) {
-            if (!gpio_is_valid_esp32(gpio) || gpio_is_unsafe_for_scan(gpio)) {
-                continue;
-            }
-            int level = gpio_get_level(gpio);
-            if (level != last_level[gpio]) {
-                last_level[gpio] = level;
-                if (level == 0) {
-                    ESP_LOGI(TAG, "GPIO scanner: button press detected on GPIO %d", gpio);
-                }
+        uint64_t levels = input_read_gpio_levels() & scan_mask;
+        uint64_t pressed = (levels ^ last_levels) & ~levels;
+        last_levels = levels;
+        for (int gpio = 0; pressed != 0; ++gpio, pressed >>= 1) {
+            if (pressed & 1) {
+                ESP_LOGI(TAG, "GPIO scanner: button press detected on GPIO %d", gpio);
             }
         }
         vTaskDelay(pdMS_TO_TICKS(50));
     }
 }
 
-static int clamp(int value, int min, int max)
-{
-    if (value < min) {
-        return min;
-    }
-    if (value > max) {
-        return max;
-    }
-    return value;
-}
-
-// Public-domain 8x8 ASCII font (font8x8_basic)
-static const uint8_t font8x8_basic[128][8] = {
-    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
-    { 0x7E,0x81,0xA5,0x81,0xBD,0x99,0x81,0x7E },
-    { 0x7E,0xFF,0xDB,0xFF,0xC3,0xE7,0xFF,0x7E },
-    { 0x6C,0xFE,0xFE,0xFE,0x7C,0x38,0x10,0x00 },
-    { 0x10,0x38,0x7C,0xFE,0x7C,0x38,0x10,0x00 },
-    { 0x38,0x7C,0x38,0xFE,0xFE,0xD6,0x10,0x38 },
-    { 0x10,0x38,0x7C,0xFE,0xFE,0x7C,0x10,0x38 },
-    { 0x00,0x00,0x18,0x3C,0x3C,0x18,0x00,0x00 },
-    { 0xFF,0xFF,0xE7,0xC3,0xC3,0xE7,0xFF,0xFF },
-    { 0x00,0x3C,0x66,0x42,0x42,0x66,0x3C,0x00 },
-    { 0xFF,0xC3,0x99,0xBD,0xBD,0x99,0xC3,0xFF },
-    { 0x0F,0x07,0x0F,0x7D,0xCC,0xCC,0xCC,0x78 },
-    { 0x3C,0x66,0x66,0x66,0x3C,0x18,0x7E,0x18 },
-    { 0x3F,0x33,0x3F,0x30,0x30,0x70,0xF0,0xE0 },
-    { 0x7F,0x63,0x7F,0x63,0x63,0x67,0xE6,0xC0 },
-    { 0x99,0x5A,0x3C,0xE7,0xE7,0x3C,0x5A,0x99 },
-    { 0x80,0xE0,0xF8,0xFE,0xF8,0xE0,0x80,0x00 },
-    { 0x02,0x0E,0x3E,0xFE,0x3E,0x0E,0x02,0x00 },
-    { 0x18,0x3C,0x7E,0x18,0x18,0x7E,0x3C,0x18 },
-    { 0x66,0x66,0x66,0x66,0x66,0x00,0x66,0x00 },
-    { 0x7F,0xDB,0xDB,0x7B,0x1B,0x1B,0x1B,0x00 },
-    { 0x3E,0x63,0x38,0x6C,0x6C,0x38,0xCC,0x78 },
-    { 0x00,0x00,0x00,0x00,0x7E,0x7E,0x7E,0x00 },
-    { 0x18,0x3C,0x7E,0x18,0x7E,0x3C,0x18,0xFF },
-    { 0x18,0x3C,0x7E,0x18,0x18,0x18,0x18,0x00 },
-    { 0x18,0x18,0x18,0x18,0x7E,0x3C,0x18,0x00 },
-    { 0x00,0x18,0x0C,0xFE,0x0C,0x18,0x00,0x00 },
-    { 0x00,0x30,0x60,0xFE,0x60,0x30,0x00,0x00 },
-    { 0x00,0x00,0xC0,0xC0,0xC0,0xFE,0x00,0x00 },
-    { 0x00,0x24,0x66,0xFF,0x66,0x24,0x00,0x00 },
-    { 0x00,0x18,0x3C,0x7E,0xFF,0xFF,0x00,0x00 },
-    { 0x00,0xFF,0xFF,0x7E,0x3C,0x18,0x00,0x00 },
-    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
-    { 0x18,0x3C,0x3C,0x18,0x18,0x00,0x18,0x00 },
-    { 0x6C,0x6C,0x24,0x00,0x00,0x00,0x00,0x00 },
-    { 0x6C,0x6C,0xFE,0x6C,0xFE,0x6C,0x6C,0x00 },
-    { 0x18,0x3E,0x60,0x3C,0x06,0x7C,0x18,0x00 },
-    { 0x00,0xC6,0xCC,0x18,0x30,0x66,0xC6,0x00 },
-    { 0x38,0x6C,0x38,0x76,0xDC,0xCC,0x76,0x00 },
-    { 0x30,0x30,0x60,0x00,0x00,0x00,0x00,0x00 },
-    { 0x0C,0x18,0x30,0x30,0x30,0x18,0x0C,0x00 },
-    { 0x30,0x18,0x0C,0x0C,0x0C,0x18,0x30,0x00 },
-    { 0x00,0x66,0x3C,0xFF,0x3C,0x66,0x00,0x00 },
-    { 0x00,0x18,0x18,0x7E,0x18,0x18,0x00,0x00 },
-    { 0x00,0x00,0x00,0x00,0x18,0x18,0x30,0x00 },
-    { 0x00,0x00,0x00,0x7E,0x00,0x00,0x00,0x00 },
-    { 0x00,0x00,0x00,0x00,0x18,0x18,0x00,0x00 },
-    { 0x06,0x0C,0x18,0x30,0x60,0xC0,0x80,0x00 },
-    { 0x7C,0xC6,0xCE,0xDE,0xF6,0xE6,0x7C,0x00 },
-    { 0x18,0x38,0x18,0x18,0x18,0x18,0x7E,0x00 },
-    { 0x7C,0xC6,0x0E,0x1C,0x70,0xC0,0xFE,0x00 },
-    { 0x7C,0xC6,0x06,0x3C,0x06,0xC6,0x7C,0x00 },
-    { 0x1C,0x3C,0x6C,0xCC,0xFE,0x0C,0x1E,0x00 },
-    { 0xFE,0xC0,0xFC,0x06,0x06,0xC6,0x7C,0x00 },
-    { 0x3C,0x60,0xC0,0xFC,0xC6,0xC6,0x7C,0x00 },
-    { 0xFE,0xC6,0x0C,0x18,0x30,0x30,0x30,0x00 },
-    { 0x7C,0xC6,0xC6,0x7C,0xC6,0xC6,0x7C,0x00 },
-    { 0x7C,0xC6,0xC6,0x7E,0x06,0x0C,0x78,0x00 },
-    { 0x00,0x18,0x18,0x00,0x00,0x18,0x18,0x00 },
-    { 0x00,0x18,0x18,0x00,0x18,0x18,0x30,0x00 },
-    { 0x0E,0x1C,0x38,0x70,0x38,0x1C,0x0E,0x00 },
-    { 0x00,0x00,0x7E,0x00,0x7E,0x00,0x00,0x00 },
-    { 0x70,0x38,0x1C,0x0E,0x1C,0x38,0x70,0x00 },
-    { 0x7C,0xC6,0x0E,0x1C,0x18,0x00,0x18,0x00 },
-    { 0x7C,0xC6,0xDE,0xDE,0xDE,0xC0,0x7C,0x00 },
-    { 0x38,0x6C,0xC6,0xC6,0xFE,0xC6,0xC6,0x00 },
-    { 0xFC,0x66,0x66,0x7C,0x66,0x66,0xFC,0x00 },
-    { 0x3C,0x66,0xC0,0xC0,0xC0,0x66,0x3C,0x00 },
-    { 0xF8,0x6C,0x66,0x66,0x66,0x6C,0xF8,0x00 },
-    { 0xFE,0x62,0x68,0x78,0x68,0x62,0xFE,0x00 },
-    { 0xFE,0x62,0x68,0x78,0x68,0x60,0xF0,0x00 },
-    { 0x3C,0x66,0xC0,0xC0,0xCE,0x66,0x3E,0x00 },
-    { 0xC6,0xC6,0xC6,0xFE,0xC6,0xC6,0xC6,0x00 },
-    { 0x3C,0x18,0x18,0x18,0x18,0x18,0x3C,0x00 },
-    { 0x1E,0x0C,0x0C,0x0C,0xCC,0xCC,0x78,0x00 },
-    { 0xE6,0x66,0x6C,0x78,0x6C,0x66,0xE6,0x00 },
-    { 0xF0,0x60,0x60,0x60,0x62,0x66,0xFE,0x00 },
-    { 0xC6,0xEE,0xFE,0xFE,0xD6,0xC6,0xC6,0x00 },
-    { 0xC6,0xE6,0xF6,0xDE,0xCE,0xC6,0xC6,0x00 },
-    { 0x38,0x6C,0xC6,0xC6,0xC6,0x6C,0x38,0x00 },
-    { 0xFC,0x66,0x66,0x7C,0x60,0x60,0xF0,0x00 },
-    { 0x38,0x6C,0xC6,0xC6,0xDA,0xCC,0x76,0x00 },
-    { 0xFC,0x66,0x66,0x7C,0x6C,0x66,0xE6,0x00 },
-    { 0x7C,0xC6,0x60,0x38,0x0C,0xC6,0x7C,0x00 },
-    { 0x7E,0x7E,0x5A,0x18,0x18,0x18,0x3C,0x00 },
-    { 0xC6,0xC6,0xC6,0xC6,0xC6,0xC6,0x7C,0x00 },
-    { 0xC6,0xC6,0xC6,0xC6,0xC6,0x6C,0x38,0x00 },
-    { 0xC6,0xC6,0xC6,0xD6,0xFE,0xEE,0xC6,0x00 },
-    { 0xC6,0xC6,0x6C,0x38,0x38,0x6C,0xC6,0x00 },
-    { 0x66,0x66,0x66,0x3C,0x18,0x18,0x3C,0x00 },
-    { 0xFE,0xC6,0x8C,0x18,0x32,0x66,0xFE,0x00 },
-    { 0x3C,0x30,0x30,0x30,0x30,0x30,0x3C,0x00 },
-    { 0xC0,0x60,0x30,0x18,0x0C,0x06,0x02,0x00 },
-    { 0x3C,0x0C,0x0C,0x0C,0x0C,0x0C,0x3C,0x00 },
-    { 0x10,0x38,0x6C,0xC6,0x00,0x00,0x00,0x00 },
-    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF },
-    { 0x30,0x18,0x0C,0x00,0x00,0x00,0x00,0x00 },
-    { 0x00,0x00,0x7C,0x06,0x7E,0xC6,0x7E,0x00 },
-    { 0xE0,0x60,0x7C,0x66,0x66,0x66,0xDC,0x00 },
-    { 0x00,0x00,0x7C,0xC6,0xC0,0xC6,0x7C,0x00 },
-    { 0x1C,0x0C,0x7C,0xCC,0xCC,0xCC,0x76,0x00 },
-    { 0x00,0x00,0x7C,0xC6,0xFE,0xC0,0x7C,0x00 },
-    { 0x3C,0x66,0x60,0xF8,0x60,0x60,0xF0,0x00 },
-    { 0x00,0x00,0x76,0xCC,0xCC,0x7C,0x0C,0xF8 },
-    { 0xE0,0x60,0x6C,0x76,0x66,0x66,0xE6,0x00 },
-    { 0x18,0x00,0x38,0x18,0x18,0x18,0x3C,0x00 },
-    { 0x06,0x00,0x06,0x06,0x06,0x66,0x66,0x3C },
-    { 0xE0,0x60,0x66,0x6C,0x78,0x6C,0xE6,0x00 },
-    { 0x38,0x18,0x18,0x18,0x18,0x18,0x3C,0x00 },
-    { 0x00,0x00,0xEC,0xFE,0xD6,0xD6,0xC6,0x00 },
-    { 0x00,0x00,0xDC,0x66,0x66,0x66,0x66,0x00 },
-    { 0x00,0x00,0x7C,0xC6,0xC6,0xC6,0x7C,0x00 },
-    { 0x00,0x00,0xDC,0x66,0x66,0x7C,0x60,0xF0 },
-    { 0x00,0x00,0x76,0xCC,0xCC,0x7C,0x0C,0x1E },
-    { 0x00,0x00,0xDC,0x76,0x66,0x60,0xF0,0x00 },
-    { 0x00,0x00,0x7E,0xC0,0x7C,0x06,0xFC,0x00 },
-    { 0x30,0x30,0xFC,0x30,0x30,0x36,0x1C,0x00 },
-    { 0x00,0x00,0xCC,0xCC,0xCC,0xCC,0x76,0x00 },
-    { 0x00,0x00,0xC6,0xC6,0xC6,0x6C,0x38,0x00 },
-    { 0x00,0x00,0xC6,0xD6,0xD6,0xFE,0x6C,0x00 },
-    { 0x00,0x00,0xC6,0x6C,0x38,0x6C,0xC6,0x00 },
-    { 0x00,0x00,0xC6,0xC6,0xC6,0x7E,0x06,0xFC },
-    { 0x00,0x00,0xFE,0x4C,0x18,0x32,0xFE,0x00 },
-    { 0x0E,0x18,0x18,0x70,0x18,0x18,0x0E,0x00 },
-    { 0x18,0x18,0x18,0x00,0x18,0x18,0x18,0x00 },
-    { 0x70,0x18,0x18,0x0E,0x18,0x18,0x70,0x00 },
-    { 0x76,0xDC,0x00,0x00,0x00,0x00,0x00,0x00 },
-    { 0x00,0x10,0x38,0x6C,0xC6,0xC6,0xFE,0x00 }
-};
-
-static void draw_char(int x, int y, char c, int scale)
-{
-    uint8_t index = (uint8_t)c;
-    if (index > 127) {
-        index = (uint8_t)'?';
-    }
-    for (int row = 0; row < 8; ++row) {
-        uint8_t bits = font8x8_basic[index][row];
-        for (int col = 0; col < 8; ++col) {
-            if (bits & (1 << (7 - col))) {
-                display_draw_rect(x + col * scale, y + row * scale, scale, scale, COLOR_WHITE);
-            }
-        }
-    }
-}
-
-static void draw_text(int x, int y, const char *text, int scale)
-{
-    int cursor = x;
-    for (const char *p = text; *p; ++p) {
-        draw_char(cursor, y, *p, scale);
-        cursor += (8 * scale) + scale;
-    }
-}
-
-static void draw_heart(int x, int y, int scale, bool filled)
-{
-    static const uint8_t heart_filled[7] = {
-        0x6C, 0xFE, 0xFE, 0xFE, 0x7C, 0x38, 0x10
-    };
-    static const uint8_t heart_outline[7] = {
-        0x6C, 0x92, 0x82, 0x44, 0x28, 0x10, 0x00
-    };
-
-    const uint8_t *bitmap = filled ? heart_filled : heart_outline;
-    for (int row = 0; row < 7; ++row) {
-        uint8_t bits = bitmap[row];
-        for (int col = 0; col < 8; ++col) {
-            if (bits & (1 << (7 - col))) {
-                display_draw_rect(x + col * scale, y + row * scale, scale, scale, COLOR_WHITE);
-            }
-        }
-    }
-}
-
-static bool button_update(button_t *btn, TickType_t now, int debounce_cycles)
+static bool button_update(button_t *btn, int debounce_cycles)
 {
     if (btn->gpio < 0) {
         return false;
     }
+#if ENABLE_INPUT_SAMPLER
+    // Debouncing already happened in the 1 kHz sampler; just pick up its result.
+    btn->stable_level = (input_sampler_buttons() & (1u << btn->id)) ? 0 : 1;
+    int64_t pressed_at;
+    return input_sampler_take_press(btn->id, &pressed_at);
+#else
     int level = gpio_get_level(btn->gpio);
     if (level != btn->last_level) {
         btn->last_level = level;
@@ -541,20 +324,63 @@ static bool button_update(button_t *btn, TickType_t now, int debounce_cycles)
     if (btn->stable_count == debounce_cycles && level != btn->stable_level) {
         btn->stable_level = level;
         if (level == 0) {
-            btn->pressed_since = now;
             return true;
         }
     }
     return false;
+#endif
+}
+
+// Paddle input as of now: the sampler's newest debounced state when there
+// is one, otherwise the buttons as of the last button_update().
+static game_input_t game_input_now(const button_t *left, const button_t *right, int paddle_speed)
+{
+#if ENABLE_INPUT_SAMPLER
+    uint32_t buttons = input_sampler_buttons();
+    bool left_pressed = left->gpio >= 0 && (buttons & (1u << left->id));
+    bool right_pressed = right->gpio >= 0 && (buttons & (1u << right->id));
+#else
+    bool left_pressed = left->gpio >= 0 && left->stable_level == 0;
+    bool right_pressed = right->gpio >= 0 && right->stable_level == 0;
+#endif
+    game_input_t input = {
+        .left = left_pressed,
+        .right = right_pressed,
+        .analog_pos = -1,
+        .paddle_speed = paddle_speed,
+    };
+#if ENABLE_ANALOG_PADDLE
+    if (!analog_paddle_read(GAME_ANALOG_RANGE, &input.analog_pos)) {
+        input.analog_pos = -1;
+    }
+#endif
+    return input;
+}
+
+// Held or still bouncing buttons need frames: debouncing, gestures and
+// long presses all advance with time.
+static bool button_busy(const button_t *btn, int debounce_cycles)
+{
+    if (btn->gpio < 0) {
+        return false;
+    }
+    if (btn->stable_level == 0) {
+        return true;
+    }
+#if ENABLE_INPUT_SAMPLER
+    return false;
+#else
+    return btn->last_level != btn->stable_level || btn->stable_count < debounce_cycles;
+#endif
 }
 
-static int nvs_load_highscore(void)
+static int nvs_load_highscore(const char *key)
 {
     nvs_handle_t handle;
     int highscore = 0;
     if (nvs_open("pong", NVS_READONLY, &handle) == ESP_OK) {
         int32_t value = 0;
-        if (nvs_get_i32(handle, "highscore", &value) == ESP_OK) {
+        if (nvs_get_i32(handle, key, &value) == ESP_OK) {
             highscore = (int)value;
         }
         nvs_close(handle);
@@ -562,142 +388,144 @@ static int nvs_load_highscore(void)
     return highscore;
 }
 
-static void nvs_save_highscore(int highscore)
+static void nvs_save_highscore(const char *key, int highscore)
 {
     nvs_handle_t handle;
     if (nvs_open("pong", NVS_READWRITE, &handle) == ESP_OK) {
-        nvs_set_i32(handle, "highscore", highscore);
+        nvs_set_i32(handle, key, highscore);
         nvs_commit(handle);
         nvs_close(handle);
     }
+    if (ENABLE_DEADLINE_MONITOR) {
+        deadline_event(DEADLINE_EVENT_NVS_COMMIT);
+    }
 }
 
-static void game_reset(ball_t *ball, paddle_t *paddle, int *hits, int *misses)
+// Set when the screen changes; the next frame is revealed with it instead
+// of being flushed at once.
+static transition_kind_t s_next_transition = TRANSITION_CUT;
+
+static void transition_next(transition_kind_t kind)
 {
-    paddle->x = SCREEN_W / 2 - PADDLE_W / 2;
-    ball->x = SCREEN_W / 2;
-    ball->y = 0;
-    ball->vx = BALL_BASE_SPEED;
-    ball->vy = BALL_BASE_SPEED;
-    *hits = 0;
-    *misses = 0;
+    if (ENABLE_TRANSITIONS) {
+        s_next_transition = kind;
+    }
 }
 
-static int ball_speed_for_hits(int hits)
+// Time from reading the input the shown paddle follows to the flush,
+// averaged over about 8 frames.
+static int64_t s_input_age_avg_us;
+
+// Everything drawn since the last mark counts as render time.
+static void flush_timed(void)
 {
-    float factor = (float)BALL_SPEED_FACTOR / 10.0f;
-    int speed = BALL_BASE_SPEED + (int)((float)hits / BALL_SPEED_STEP_HITS * factor);
-    if (speed > BALL_MAX_SPEED) {
-        speed = BALL_MAX_SPEED;
+    if (ENABLE_DEADLINE_MONITOR) {
+        deadline_phase(DEADLINE_RENDER);
+    }
+    if (s_next_transition != TRANSITION_CUT) {
+        transition_start(s_next_transition, TRANSITION_US);
+        s_next_transition = TRANSITION_CUT;
+    } else {
+        display_flush();
+    }
+    if (ENABLE_DEADLINE_MONITOR) {
+        deadline_phase(DEADLINE_FLUSH);
     }
-    return speed;
 }
 
-static void game_step(ball_t *ball, paddle_t *paddle, int *hits, int *misses)
+static void render_stats_overlay(const frame_governor_t *gov)
 {
-    ball->x += ball->vx;
-    ball->y += ball->vy;
-
-    if (ball->x <= 0 || ball->x + BALL_SIZE >= SCREEN_W) {
-        ball->vx = -ball->vx;
-    }
-
-    if (ball->y <= 0) {
-        ball->vy = -ball->vy;
-    }
-
-    int paddle_y = SCREEN_H - PADDLE_H - 2;
-    if (ball->y + BALL_SIZE >= paddle_y) {
-        if (ball->x + BALL_SIZE >= paddle->x && ball->x <= paddle->x + PADDLE_W) {
-            ball->vy = -ball->vy;
-            ball->y = paddle_y - BALL_SIZE - 1;
-            (*hits)++;
-            int speed = ball_speed_for_hits(*hits);
-            ball->vx = (ball->vx < 0) ? -speed : speed;
-            ball->vy = -speed;
-        } else if (ball->y + BALL_SIZE >= SCREEN_H) {
-            (*misses)++;
-            ball->x = SCREEN_W / 2;
-            ball->y = 0;
-            int speed = ball_speed_for_hits(0);
-            ball->vx = (ball->vx > 0) ? -speed : speed;
-            ball->vy = speed;
-        }
-    }
+    char buf[48];
+    int len = snprintf(buf, sizeof(buf), "R:%lldus Q:%d S:%d",
+                       (long long)gov->work_avg_us, (int)gov->quality, gov->skip_interval);
+    if (ENABLE_DEADLINE_MONITOR) {
+        len += snprintf(buf + len, sizeof(buf) - len, " M:%lu", (unsigned long)deadline_misses());
+    }
+    snprintf(buf + len, sizeof(buf) - len, " W:%lu I:%lldus", (unsigned long)wake_rate(),
+             (long long)s_input_age_avg_us);
+    draw_text(UI_MARGIN, UI_MARGIN + 18 * UI_SCALE, buf, UI_SCALE);
 }
 
-static void game_render(const ball_t *ball, const paddle_t *paddle, int hits, int misses, bool show_highscore, int highscore, bool paused)
+static void render_game(const mini_game_t *game, void *state, const game_render_ctx_t *ctx, const frame_governor_t *gov)
 {
     display_clear(COLOR_BLACK);
+    game->render(state, ctx);
 
-    int paddle_y = SCREEN_H - PADDLE_H - 2;
-    display_draw_rect(paddle->x, paddle_y, PADDLE_W, PADDLE_H, COLOR_WHITE);
-    display_draw_rect(ball->x, ball->y, BALL_SIZE, BALL_SIZE, COLOR_WHITE);
-
-    char buf[32];
-    if (show_highscore) {
-        snprintf(buf, sizeof(buf), "HISCORE:%d H:%d", highscore, hits);
-    } else {
-        snprintf(buf, sizeof(buf), "H:%d", hits);
+    if (ENABLE_STATS_OVERLAY && (ctx->flags & RENDER_OVERLAY)) {
+        render_stats_overlay(gov);
     }
-    int hud_scale = show_highscore ? 1 : 2;
-    draw_text(2, 2, buf, hud_scale);
 
-    int lives = MAX_LIVES - misses;
-    if (lives < 0) {
-        lives = 0;
-    }
-    int heart_scale = 1;
-    int heart_w = 8 * heart_scale;
-    int heart_spacing = 2;
-    int total_w = MAX_LIVES * heart_w + (MAX_LIVES - 1) * heart_spacing;
-    int hearts_x = SCREEN_W - total_w - 2;
-    int hearts_y = 2;
-    for (int i = 0; i < MAX_LIVES; ++i) {
-        draw_heart(hearts_x + i * (heart_w + heart_spacing), hearts_y, heart_scale, i < lives);
+    if (ctx->paused) {
+        draw_text_centered((SCREEN_H / 2) - 4 * UI_SCALE, "PAUSE", UI_SCALE);
     }
+}
 
-    if (paused) {
-        draw_text((SCREEN_W / 2) - 20, (SCREEN_H / 2) - 4, "PAUSE", 1);
-    }
+static void render_start_screen(const mini_game_t *game, int highscore, int last_score)
+{
+    start_screen_draw(game->name, highscore, last_score);
+    flush_timed();
+}
 
+#if ENABLE_BENCH
+static void bench_start_screen(void)
+{
+    start_screen_draw(k_games[0]->name, 1234, 567);
     display_flush();
 }
+#endif
 
-static void render_start_screen(int highscore, int last_score)
+// Runs at a frame boundary, so a tuning change never lands mid-frame.
+static void apply_tunables(const tunables_t *tun, frame_governor_t *gov)
 {
-    display_clear(COLOR_BLACK);
+    governor_set_timing(gov, tun->sim_tick_us, tun->frame_budget_us);
+    deadline_set_period(tun->sim_tick_us);
+    difficulty_set_curve((difficulty_curve_t)tun->curve);
+    difficulty_tune(tun->ball_base_speed, tun->ball_max_speed, tun->ramp_hits);
+}
 
-    const char *title_line1 = "Carl's";
-    const char *title_line2 = "Pong";
-    int title_scale = 2;
-    int title_w1 = (int)strlen(title_line1) * ((8 * title_scale) + title_scale);
-    int title_w2 = (int)strlen(title_line2) * ((8 * title_scale) + title_scale);
-    int title_x1 = (SCREEN_W - title_w1) / 2;
-    int title_x2 = (SCREEN_W - title_w2) / 2;
-    int title_y1 = 16;
-    int title_y2 = title_y1 + (8 * title_scale) + 4;
-    draw_text(title_x1, title_y1, title_line1, title_scale);
-    draw_text(title_x2, title_y2, title_line2, title_scale);
-
-    char buf[32];
-    snprintf(buf, sizeof(buf), "HIGH:%d", highscore);
-    int info_scale = 2;
-    int info_w = (int)strlen(buf) * ((8 * info_scale) + info_scale);
-    int info_x = (SCREEN_W - info_w) / 2;
-    draw_text(info_x, 70, buf, info_scale);
-
-    if (last_score >= 0) {
-        snprintf(buf, sizeof(buf), "LETZTE:%d", last_score);
-        int last_scale = 1;
-        int last_w = (int)strlen(buf) * ((8 * last_scale) + last_scale);
-        int last_x = (SCREEN_W - last_w) / 2;
-        int last_y = 70 + (8 * info_scale) + 6;
-        draw_text(last_x, last_y, buf, last_scale);
-    }
-
-    draw_text(20, SCREEN_H - 20, "PRESS BOOT", 1);
-    display_flush();
+// While anything moves, sleeps until the next step is due; otherwise until
+// an event arrives. Returns the wake reasons.
+static uint32_t frame_wait(frame_governor_t *gov, bool animating)
+{
+    if (ENABLE_DEADLINE_MONITOR) {
+        deadline_end_frame();
+    }
+    if (animating) {
+        return wake_wait(governor_time_to_next_step(gov));
+    }
+    uint32_t woke = wake_wait(WAKE_NO_FRAME);
+    // Idle time is not owed to the simulation.
+    governor_reset_clock(gov);
+    return woke;
+}
+
+#if ENABLE_REWIND
+// Records the game state up to the end of what the game allocated, or as
+// much of it as the game says holds its state.
+static void rewind_begin(const mini_game_t *game, void *state, const arena_t *arena)
+{
+    size_t size = arena->used - (size_t)((uint8_t *)state - arena->base);
+    if (game->snapshot_size) {
+        size = game->snapshot_size(state);
+    }
+    rewind_start(state, size);
+}
+#endif
+
+// Ends the running game and hands its memory back in one go.
+static void game_exit(const mini_game_t *game, void *state, arena_t *arena)
+{
+#if ENABLE_REWIND
+    rewind_stop();
+#endif
+    if (ENABLE_STATE_HASH) {
+        state_hash_end();
+    }
+    if (game->teardown) {
+        game->teardown(state);
+    }
+    ESP_LOGI(TAG, "%s used %u of %u arena bytes", game->name, (unsigned)arena->peak, (unsigned)arena->size);
+    arena_reset(arena);
 }
 
 void app_main(void)
@@ -717,51 +545,170 @@ void app_main(void)
         ESP_LOGW(TAG, "NVS init failed, highscore will not persist");
     }
 
-    display_init();
+    const tunables_t tuning_defaults = {
+        .pclk_hz = LCD_PCLK_HZ,
+        .sim_tick_us = SIM_TICK_US,
+        .frame_budget_us = FRAME_BUDGET_US,
+        .debounce_cycles = 3,
+        .paddle_speed = 3,
+        .ball_base_speed = BALL_BASE_SPEED,
+        .ball_max_speed = BALL_MAX_SPEED,
+        .ramp_hits = DIFFICULTY_RAMP_HITS,
+        .curve = difficulty_get_curve(),
+    };
+    tunables_t tun = tuning_defaults;
+    tuning_init(&tuning_defaults);
+    tuning_take(&tun);
+
+    wake_init();
+    display_init(tun.pclk_hz);
+#if CONFIG_PONG_RENDER_BENCH
+    display_render_bench();
+#endif
     buttons_init();
-
-    paddle_t paddle = { .x = SCREEN_W / 2 - PADDLE_W / 2 };
-
-    ball_t ball = {
-        .x = SCREEN_W / 2,
-        .y = SCREEN_H / 2,
-        .vx = BALL_BASE_SPEED,
-        .vy = BALL_BASE_SPEED
+    static gesture_engine_t s_gestures;
+    gesture_init(&s_gestures, k_gestures, GESTURE_COUNT);
+#if ENABLE_INPUT_SAMPLER
+    const int input_gpios[INPUT_BUTTON_COUNT] = {
+        [INPUT_LEFT] = GPIO_LEFT,
+        [INPUT_RIGHT] = GPIO_RIGHT,
+        [INPUT_PAUSE] = GPIO_PAUSE,
     };
+    ESP_ERROR_CHECK(input_sampler_start(input_gpios));
+    input_sampler_set_gestures(&s_gestures);
+#endif
+#if ENABLE_TOUCH_PADDLE
+    if (touch_paddle_start() != ESP_OK) {
+        ESP_LOGW(TAG, "Touch paddle init failed");
+    }
+#endif
+#if ENABLE_ANALOG_PADDLE
+    if (analog_paddle_start() != ESP_OK) {
+        ESP_LOGW(TAG, "Analog paddle init failed, using buttons");
+    }
+#endif
 
-    const int paddle_speed = 3;
-    const TickType_t frame_delay = pdMS_TO_TICKS(16);
-    const int debounce_cycles = 3;
-    const TickType_t long_press_ms = pdMS_TO_TICKS(800);
-    const TickType_t reset_hold_ms = pdMS_TO_TICKS(3000);
+    // Game state lives in this arena and is dropped wholesale on exit.
+    static uint8_t s_arena_buffer[GAME_ARENA_SIZE] __attribute__((aligned(ARENA_ALIGN)));
+    arena_t arena;
+    arena_init(&arena, s_arena_buffer, sizeof(s_arena_buffer));
 
-    button_t left_btn = { .gpio = GPIO_LEFT, .stable_level = 1, .last_level = 1, .stable_count = 0, .pressed_since = 0 };
-    button_t right_btn = { .gpio = GPIO_RIGHT, .stable_level = 1, .last_level = 1, .stable_count = 0, .pressed_since = 0 };
-    button_t pause_btn = { .gpio = GPIO_PAUSE, .stable_level = 1, .last_level = 1, .stable_count = 0, .pressed_since = 0 };
+    button_t left_btn = { .gpio = GPIO_LEFT, .id = INPUT_LEFT, .stable_level = 1, .last_level = 1, .stable_count = 0 };
+    button_t right_btn = { .gpio = GPIO_RIGHT, .id = INPUT_RIGHT, .stable_level = 1, .last_level = 1, .stable_count = 0 };
+    button_t pause_btn = { .gpio = GPIO_PAUSE, .id = INPUT_PAUSE, .stable_level = 1, .last_level = 1, .stable_count = 0 };
 
-    int hits = 0;
-    int misses = 0;
-    int highscore = nvs_load_highscore();
+    int selected = 0;
+    const mini_game_t *game = k_games[selected];
+    void *game_state = NULL;
+    int highscore = nvs_load_highscore(game->highscore_key);
     int last_score = -1;
-    bool show_highscore = false;
-    TickType_t both_pressed_since = 0;
-    bool both_pressed_active = false;
-    bool highscore_reset_done = false;
+    // Set once the running game was rewound.
+    bool rewound = false;
+    // The input the last late latch moved the paddle from, which the next
+    // step applies in place of the input read at the top of the loop.
+    game_input_t latched_input = { 0 };
+    bool input_latched = false;
+    // Seed and steps so far of the running game, for scripted input.
+    uint32_t run_seed = 0;
+    uint32_t run_steps = 0;
+    // Left/right buttons pressed on the start screen since all were up.
+    uint32_t select_buttons = 0;
     game_state_t state = STATE_START;
 
     if (GPIO_PAUSE == 0) {
         ESP_LOGW(TAG, "Pause on GPIO0 (BOOT). Do not hold during reset.");
     }
 
+    frame_governor_t governor;
+    governor_init(&governor, SIM_TICK_US, FRAME_BUDGET_US);
+    deadline_init(SIM_TICK_US);
+    apply_tunables(&tun, &governor);
+
+#if ENABLE_TUNING_CONSOLE
+    if (tuning_console_start() != ESP_OK) {
+        ESP_LOGW(TAG, "Tuning console failed to start");
+    }
+#endif
+#if ENABLE_BENCH
+    if (bench_register_command() != ESP_OK) {
+        ESP_LOGW(TAG, "Benchmark command not available");
+    }
+#endif
+#if ENABLE_TUNING_CONSOLE && ENABLE_DEADLINE_MONITOR
+    if (deadline_register_command() != ESP_OK) {
+        ESP_LOGW(TAG, "Deadline command not available");
+    }
+#endif
+#if ENABLE_TUNING_CONSOLE
+    if (wake_register_command() != ESP_OK) {
+        ESP_LOGW(TAG, "Wakeups command not available");
+    }
+#endif
+#if ENABLE_TUNING_CONSOLE && ENABLE_REWIND
+    if (rewind_register_command() != ESP_OK) {
+        ESP_LOGW(TAG, "Rewind command not available");
+    }
+#endif
+
+    // Why the loop last woke up; the first frame is drawn as if on input.
+    uint32_t woke = WAKE_INPUT;
     while (true) {
-        TickType_t now = xTaskGetTickCount();
+#if ENABLE_BENCH
+        if (!transition_active() && bench_poll(bench_start_screen)) {
+            governor_reset_clock(&governor);
+        }
+#endif
+        bool retuned = tuning_take(&tun);
+        if (retuned) {
+            apply_tunables(&tun, &governor);
+        }
+        int steps = governor_begin_frame(&governor);
+        if (ENABLE_DEADLINE_MONITOR) {
+            deadline_begin_frame(steps);
+            if (retuned) {
+                deadline_event(DEADLINE_EVENT_TUNING);
+            }
+        }
 
-        button_update(&left_btn, now, debounce_cycles);
-        button_update(&right_btn, now, debounce_cycles);
-        if (button_update(&pause_btn, now, debounce_cycles)) {
+        // The revealed frame is on hold until the transition is done; the
+        // game resumes from there rather than catching up.
+        if (transition_active()) {
+            if (!transition_step()) {
+                governor_reset_clock(&governor);
+            }
+            woke = frame_wait(&governor, true);
+            continue;
+        }
+
+        bool left_edge = button_update(&left_btn, tun.debounce_cycles);
+        bool right_edge = button_update(&right_btn, tun.debounce_cycles);
+        if (button_update(&pause_btn, tun.debounce_cycles)) {
             if (state == STATE_START) {
-                game_reset(&ball, &paddle, &hits, &misses);
-                state = STATE_RUN;
+                uint32_t seed = STATE_HASH_SEED ? STATE_HASH_SEED : esp_random();
+                game_state = game->init(&arena, seed);
+                if (ENABLE_DEADLINE_MONITOR) {
+                    deadline_event(DEADLINE_EVENT_GAME_CHANGE);
+                }
+                if (game_state) {
+#if ENABLE_REWIND
+                    rewind_begin(game, game_state, &arena);
+#endif
+                    if (ENABLE_STATE_HASH && game->hash) {
+                        state_hash_begin(game->name, seed);
+                    }
+                    rewound = false;
+                    input_latched = false;
+                    select_buttons = 0;
+                    run_seed = seed;
+                    run_steps = 0;
+                    governor_reset_clock(&governor);
+                    steps = 0;
+                    state = STATE_RUN;
+                    transition_next(TRANSITION_WIPE);
+                } else {
+                    ESP_LOGE(TAG, "%s does not fit the %u byte arena", game->name, (unsigned)arena.size);
+                    arena_reset(&arena);
+                }
             } else if (state == STATE_RUN) {
                 state = STATE_PAUSE;
             } else {
@@ -769,62 +716,152 @@ void app_main(void)
             }
         }
 
+        bool buttons_busy = button_busy(&left_btn, tun.debounce_cycles) ||
+                            button_busy(&right_btn, tun.debounce_cycles) ||
+                            button_busy(&pause_btn, tun.debounce_cycles);
+
+#if !ENABLE_INPUT_SAMPLER
+        // Without the sampler, gestures are evaluated at frame rate.
         bool left_pressed = (left_btn.gpio >= 0) && (left_btn.stable_level == 0);
         bool right_pressed = (right_btn.gpio >= 0) && (right_btn.stable_level == 0);
-
-        if (left_pressed) {
-            paddle.x -= paddle_speed;
-        }
-        if (right_pressed) {
-            paddle.x += paddle_speed;
+        bool pause_pressed = (pause_btn.gpio >= 0) && (pause_btn.stable_level == 0);
+        gesture_update(&s_gestures,
+                       (left_pressed ? 1u << INPUT_LEFT : 0) | (right_pressed ? 1u << INPUT_RIGHT : 0) |
+                           (pause_pressed ? 1u << INPUT_PAUSE : 0),
+                       esp_timer_get_time());
+#endif
+        // Taken every frame so a gesture completed in another state does not
+        // fire later.
+        bool reset_highscore = gesture_take(&s_gestures, GESTURE_RESET_HIGHSCORE);
+        bool quit = gesture_take(&s_gestures, GESTURE_QUIT);
+        if (ENABLE_DEADLINE_MONITOR) {
+            deadline_phase(DEADLINE_INPUT);
         }
-        paddle.x = clamp(paddle.x, 0, SCREEN_W - PADDLE_W);
 
         if (state == STATE_START) {
-            if (left_pressed && right_pressed) {
-                if (!both_pressed_active) {
-                    both_pressed_active = true;
-                    both_pressed_since = now;
-                    highscore_reset_done = false;
-                }
-                if (!highscore_reset_done && (now - both_pressed_since) >= reset_hold_ms) {
-                    highscore = 0;
-                    nvs_save_highscore(highscore);
-                    highscore_reset_done = true;
-                }
-            } else {
-                both_pressed_active = false;
+            // Left/right pick the game once released, and only if pressed on
+            // their own: the reset chord holds both and leaves the game be.
+            uint32_t held = (left_btn.stable_level == 0 ? 1u << INPUT_LEFT : 0) |
+                            (right_btn.stable_level == 0 ? 1u << INPUT_RIGHT : 0);
+            select_buttons |= (left_edge ? 1u << INPUT_LEFT : 0) | (right_edge ? 1u << INPUT_RIGHT : 0);
+            if (select_buttons) {
+                select_buttons |= held;
+            }
+            int delta = 0;
+            if (select_buttons && !held) {
+                delta = select_buttons == 1u << INPUT_RIGHT ? 1 : select_buttons == 1u << INPUT_LEFT ? -1 : 0;
+                select_buttons = 0;
             }
-            render_start_screen(highscore, last_score);
-            vTaskDelay(frame_delay);
+            if (delta) {
+                selected = (selected + delta + GAME_COUNT) % GAME_COUNT;
+                game = k_games[selected];
+                highscore = nvs_load_highscore(game->highscore_key);
+                last_score = -1;
+                transition_next(TRANSITION_SLIDE);
+            }
+            if (reset_highscore) {
+                highscore = 0;
+                nvs_save_highscore(game->highscore_key, highscore);
+            }
+            render_start_screen(game, highscore, last_score);
+            woke = frame_wait(&governor, buttons_busy || transition_active());
             continue;
         }
 
-        show_highscore = false;
-        if (left_pressed && (now - left_btn.pressed_since) >= long_press_ms) {
-            show_highscore = true;
+        // Games advance once per simulation step, so gameplay speed does not
+        // depend on how long the previous frame took to render.
+        game_input_t input = game_input_now(&left_btn, &right_btn, tun.paddle_speed);
+        int64_t input_at = esp_timer_get_time();
+
+        // Quitting is only honoured while paused: the press that paused the
+        // game is the start of the hold, and the press that started a game
+        // cannot quit it.
+        bool game_over = quit && state == STATE_PAUSE;
+        // Rewinding replaces the steps due with as many recorded ones, so
+        // play runs backwards at its own speed.
+        bool rewinding = ENABLE_REWIND && state == STATE_RUN && gesture_active(&s_gestures, GESTURE_REWIND);
+        for (int i = 0; i < steps && !game_over && state == STATE_RUN; ++i) {
+#if ENABLE_REWIND
+            if (rewinding) {
+                input_latched = false;
+                if (rewind_step_back()) {
+                    rewound = true;
+                    if (ENABLE_STATE_HASH) {
+                        // The run no longer compares with another.
+                        state_hash_end();
+                    }
+                    if (game->rewound) {
+                        game->rewound(game_state);
+                    }
+                }
+                continue;
+            }
+#endif
+            if (ENABLE_STATE_HASH_SCRIPT) {
+                input = state_hash_script_input(run_seed, run_steps);
+            }
+            game_over = !game->tick(game_state, &input);
+            run_steps++;
+            if (ENABLE_STATE_HASH && game->hash) {
+                state_hash_tick(game->hash(game_state), input_latched ? &latched_input : &input);
+            }
+            input_latched = false;
+#if ENABLE_REWIND
+            rewind_record();
+#endif
+        }
+
+        // Practice runs do not count.
+        int score = game->score(game_state);
+        if (score > highscore && !rewound) {
+            highscore = score;
+            nvs_save_highscore(game->highscore_key, highscore);
         }
-        if (right_pressed && (now - right_btn.pressed_since) >= long_press_ms) {
-            show_highscore = true;
+
+        if (ENABLE_DEADLINE_MONITOR) {
+            deadline_phase(DEADLINE_SIM);
         }
 
-        if (state == STATE_RUN) {
-            game_step(&ball, &paddle, &hits, &misses);
-            if (hits > highscore) {
-                highscore = hits;
-                nvs_save_highscore(highscore);
-            }
-            if (misses >= MAX_LIVES) {
-                last_score = hits;
-                state = STATE_START;
-                game_reset(&ball, &paddle, &hits, &misses);
-                vTaskDelay(frame_delay);
-                continue;
+        if (game_over) {
+            if (ENABLE_DEADLINE_MONITOR) {
+                deadline_event(DEADLINE_EVENT_GAME_CHANGE);
             }
+            last_score = score;
+            game_exit(game, game_state, &arena);
+            game_state = NULL;
+            state = STATE_START;
+            transition_next(TRANSITION_DISSOLVE);
+            woke = frame_wait(&governor, true);
+            continue;
         }
 
-        game_render(&ball, &paddle, hits, misses, show_highscore, highscore, state == STATE_PAUSE);
+        // A frame wake-up with no step due has nothing new to show.
+        if ((steps > 0 || (woke & ~WAKE_FRAME)) && governor_should_present(&governor)) {
+            int64_t render_start = esp_timer_get_time();
+            game_render_ctx_t ctx = {
+                .show_highscore = gesture_active(&s_gestures, GESTURE_SHOW_HIGHSCORE_LEFT) ||
+                                  gesture_active(&s_gestures, GESTURE_SHOW_HIGHSCORE_RIGHT),
+                .highscore = highscore,
+                .paused = state == STATE_PAUSE,
+                .flags = governor_render_flags(&governor),
+                .late_paddle = ENABLE_LATE_LATCH && state == STATE_RUN && !rewinding && game->latch,
+            };
+            render_game(game, game_state, &ctx, &governor);
+            if (ctx.late_paddle) {
+                // Drawn last from the newest input, the paddle waits only for
+                // the flush.
+                game_input_t latest = ENABLE_STATE_HASH_SCRIPT ? state_hash_script_input(run_seed, run_steps)
+                                                               : game_input_now(&left_btn, &right_btn, tun.paddle_speed);
+                input_at = esp_timer_get_time();
+                game->latch(game_state, &latest);
+                latched_input = latest;
+                input_latched = true;
+            }
+            s_input_age_avg_us += (esp_timer_get_time() - input_at - s_input_age_avg_us) / 8;
+            flush_timed();
+            governor_end_frame(&governor, esp_timer_get_time() - render_start);
+        }
 
-        vTaskDelay(frame_delay);
+        woke = frame_wait(&governor, state == STATE_RUN || buttons_busy || transition_active());
     }
 }
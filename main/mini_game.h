@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+// Every game's state is carved out of one static arena that the launcher
+// resets when the game exits.
+#define GAME_ARENA_SIZE (8 * 1024)
+
+// Full scale of game_input_t.analog_pos.
+#define GAME_ANALOG_RANGE 1024
+
+typedef struct {
+    bool left;
+    bool right;
+    // Analog paddle position 0..GAME_ANALOG_RANGE, or -1 without one.
+    int analog_pos;
+    int paddle_speed;
+} game_input_t;
+
+typedef struct {
+    bool show_highscore;
+    int highscore;
+    bool paused;
+    // RENDER_* flags from the frame governor.
+    unsigned flags;
+    // The paddle is left out: latch() draws it once the rest is drawn.
+    bool late_paddle;
+} game_render_ctx_t;
+
+typedef struct {
+    const char *name;
+    // NVS key for the game's highscore in the "pong" namespace.
+    const char *highscore_key;
+    // Allocates the game state from the arena; NULL if it does not fit.
+    void *(*init)(arena_t *arena, uint32_t seed);
+    // Advances one simulation step; returns false on game over.
+    bool (*tick)(void *state, const game_input_t *input);
+    // Draws into the framebuffer; the launcher flushes.
+    void (*render)(void *state, const game_render_ctx_t *ctx);
+    int (*score)(const void *state);
+    // Optional late latch, called after render() and right before the flush
+    // with the newest input. Moves the paddle as the next tick would and
+    // draws it; that tick then keeps the latched position, so collisions use
+    // what was shown.
+    void (*latch)(void *state, const game_input_t *input);
+    // Optional, for rewind: the number of bytes at the start of the state
+    // that hold it, and a hook that rebuilds whatever follows them from
+    // those bytes once an earlier state was copied back. Without them the
+    // whole arena is recorded.
+    size_t (*snapshot_size)(const void *state);
+    void (*rewound)(void *state);
+    // Optional hash of the simulation state for determinism checks; see
+    // state_hash.h.
+    uint32_t (*hash)(const void *state);
+    // Optional; the arena is reset right after it returns.
+    void (*teardown)(void *state);
+} mini_game_t;
+
+extern const mini_game_t g_game_pong;
+extern const mini_game_t g_game_obstacles;
+extern const mini_game_t g_game_catch;
+
+// Shared paddle control: the analog position when there is one, otherwise
+// the buttons move it by paddle_speed. Clamped to the screen.
+static inline int mini_game_paddle_x(int x, int w, int screen_w, const game_input_t *input)
+{
+    if (input->analog_pos >= 0) {
+        x = input->analog_pos * (screen_w - w) / GAME_ANALOG_RANGE;
+    } else {
+        if (input->left) {
+            x -= input->paddle_speed;
+        }
+        if (input->right) {
+            x += input->paddle_speed;
+        }
+    }
+    if (x < 0) {
+        return 0;
+    }
+    if (x > screen_w - w) {
+        return screen_w - w;
+    }
+    return x;
+}
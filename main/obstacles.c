@@ -0,0 +1,181 @@
+#include "obstacles.h"
+
+#include "rng.h"
+
+#include <string.h>
+
+// Obstacles live in a band between the HUD and the paddle.
+#define FIELD_TOP 24
+#define FIELD_BOTTOM (SCREEN_H - 40)
+
+// Placement slots keep obstacles from overlapping at generation time.
+#define SLOT_W (OBSTACLE_W + 2)
+#define SLOT_H (OBSTACLE_H + 2)
+#define SLOT_COLS (SCREEN_W / SLOT_W)
+#define SLOT_ROWS ((FIELD_BOTTOM - FIELD_TOP) / SLOT_H)
+#define SLOT_COUNT (SLOT_COLS * SLOT_ROWS)
+
+// Every MOVING_EVERY-th obstacle patrols horizontally around its slot.
+#define MOVING_EVERY 8
+#define PATROL_RANGE 12
+
+// Static obstacles break on the first hit. Moving ones take a few, so they
+// still shape rallies but can never wall the ball in for good.
+#define STATIC_HP 1
+#define MOVING_HP 3
+
+_Static_assert(OBSTACLE_W <= GRID_CELL && OBSTACLE_H <= GRID_CELL, "obstacle larger than a grid cell");
+_Static_assert(OBSTACLE_MAX <= UINT16_MAX, "cell lists hold 16-bit indices");
+
+static int clamp_cell(int v, int max)
+{
+    if (v < 0) {
+        return 0;
+    }
+    if (v > max) {
+        return max;
+    }
+    return v;
+}
+
+static bool rect_overlap(rect_t a, int bx, int by, int bw, int bh)
+{
+    return a.x < bx + bw && bx < a.x + a.w && a.y < by + bh && by < a.y + a.h;
+}
+
+void obstacles_rebuild_grid(obstacle_field_t *field)
+{
+    uint16_t *start = field->cell_start;
+    memset(start, 0, sizeof(field->cell_start));
+
+    // Counting sort: count entries per cell, prefix-sum, then scatter.
+    for (int i = 0; i < field->count; ++i) {
+        const obstacle_t *o = &field->items[i];
+        int c0 = clamp_cell(o->x / GRID_CELL, GRID_COLS - 1);
+        int c1 = clamp_cell((o->x + OBSTACLE_W - 1) / GRID_CELL, GRID_COLS - 1);
+        int r0 = clamp_cell(o->y / GRID_CELL, GRID_ROWS - 1);
+        int r1 = clamp_cell((o->y + OBSTACLE_H - 1) / GRID_CELL, GRID_ROWS - 1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                start[r * GRID_COLS + c + 1]++;
+            }
+        }
+    }
+    for (int c = 0; c < GRID_CELLS; ++c) {
+        start[c + 1] += start[c];
+    }
+
+    uint16_t fill[GRID_CELLS];
+    memcpy(fill, start, sizeof(fill));
+    for (int i = 0; i < field->count; ++i) {
+        const obstacle_t *o = &field->items[i];
+        int c0 = clamp_cell(o->x / GRID_CELL, GRID_COLS - 1);
+        int c1 = clamp_cell((o->x + OBSTACLE_W - 1) / GRID_CELL, GRID_COLS - 1);
+        int r0 = clamp_cell(o->y / GRID_CELL, GRID_ROWS - 1);
+        int r1 = clamp_cell((o->y + OBSTACLE_H - 1) / GRID_CELL, GRID_ROWS - 1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                field->cell_items[fill[r * GRID_COLS + c]++] = (uint16_t)i;
+            }
+        }
+    }
+}
+
+void obstacles_generate(obstacle_field_t *field, int count, uint32_t seed)
+{
+    if (count > OBSTACLE_MAX) {
+        count = OBSTACLE_MAX;
+    }
+    if (count > SLOT_COUNT) {
+        count = SLOT_COUNT;
+    }
+
+    uint16_t slots[SLOT_COUNT];
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        slots[i] = (uint16_t)i;
+    }
+
+    uint32_t rng = seed ? seed : 1;
+    field->count = (uint16_t)count;
+    for (int i = 0; i < count; ++i) {
+        // Partial Fisher-Yates shuffle picks distinct slots.
+        int j = i + rng_range(&rng, SLOT_COUNT - i);
+        uint16_t slot = slots[j];
+        slots[j] = slots[i];
+        slots[i] = slot;
+
+        obstacle_t *o = &field->items[i];
+        o->x = (int16_t)((slot % SLOT_COLS) * SLOT_W + 1);
+        o->y = (int16_t)(FIELD_TOP + (slot / SLOT_COLS) * SLOT_H + 1);
+        o->vx = (i % MOVING_EVERY == 0) ? ((rng_next(&rng) & 1) ? 1 : -1) : 0;
+        o->hp = o->vx ? MOVING_HP : STATIC_HP;
+        o->min_x = (int16_t)(o->x - PATROL_RANGE < 0 ? 0 : o->x - PATROL_RANGE);
+        o->max_x = (int16_t)(o->x + PATROL_RANGE > SCREEN_W - OBSTACLE_W ? SCREEN_W - OBSTACLE_W : o->x + PATROL_RANGE);
+    }
+
+    obstacles_rebuild_grid(field);
+}
+
+void obstacles_update(obstacle_field_t *field)
+{
+    bool moved = false;
+    for (int i = 0; i < field->count; ++i) {
+        obstacle_t *o = &field->items[i];
+        if (o->vx == 0) {
+            continue;
+        }
+        o->x += o->vx;
+        if (o->x <= o->min_x || o->x >= o->max_x) {
+            o->vx = -o->vx;
+        }
+        moved = true;
+    }
+    if (moved) {
+        obstacles_rebuild_grid(field);
+    }
+}
+
+bool obstacles_damage(obstacle_field_t *field, int index)
+{
+    if (index < 0 || index >= field->count) {
+        return false;
+    }
+    obstacle_t *o = &field->items[index];
+    if (o->hp > 1) {
+        o->hp--;
+        return false;
+    }
+    obstacles_remove(field, index);
+    return true;
+}
+
+void obstacles_remove(obstacle_field_t *field, int index)
+{
+    if (index < 0 || index >= field->count) {
+        return;
+    }
+    field->items[index] = field->items[--field->count];
+    obstacles_rebuild_grid(field);
+}
+
+int obstacles_hit_grid(const obstacle_field_t *field, rect_t box)
+{
+    int c0 = clamp_cell(box.x / GRID_CELL, GRID_COLS - 1);
+    int c1 = clamp_cell((box.x + box.w - 1) / GRID_CELL, GRID_COLS - 1);
+    int r0 = clamp_cell(box.y / GRID_CELL, GRID_ROWS - 1);
+    int r1 = clamp_cell((box.y + box.h - 1) / GRID_CELL, GRID_ROWS - 1);
+
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            int cell = r * GRID_COLS + c;
+            for (int k = field->cell_start[cell]; k < field->cell_start[cell + 1]; ++k) {
+                int i = field->cell_items[k];
+                const obstacle_t *o = &field->items[i];
+                if (rect_overlap(box, o->x, o->y, OBSTACLE_W, OBSTACLE_H)) {
+                    return i;
+                }
+            }
+        }
+    }
+    return -1;
+}
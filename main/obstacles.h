@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "game_config.h"
+
+#define OBSTACLE_MAX 256
+#define OBSTACLE_W 6
+#define OBSTACLE_H 4
+
+// Uniform broadphase grid over the playfield. Obstacles are never larger than
+// a cell, so each one lands in at most four cells.
+#define GRID_CELL 16
+#define GRID_COLS ((SCREEN_W + GRID_CELL - 1) / GRID_CELL)
+#define GRID_ROWS ((SCREEN_H + GRID_CELL - 1) / GRID_CELL)
+#define GRID_CELLS (GRID_COLS * GRID_ROWS)
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t min_x;
+    int16_t max_x;
+    int8_t vx;
+    // Hits left before the obstacle breaks.
+    uint8_t hp;
+} obstacle_t;
+
+typedef struct {
+    obstacle_t items[OBSTACLE_MAX];
+    uint16_t count;
+    // Compact per-cell index lists: cell c owns cell_items[cell_start[c] .. cell_start[c + 1]).
+    uint16_t cell_start[GRID_CELLS + 1];
+    uint16_t cell_items[OBSTACLE_MAX * 4];
+} obstacle_field_t;
+
+typedef struct {
+    int x;
+    int y;
+    int w;
+    int h;
+} rect_t;
+
+void obstacles_generate(obstacle_field_t *field, int count, uint32_t seed);
+
+// Advances moving obstacles by one step and rebuilds the grid.
+void obstacles_update(obstacle_field_t *field);
+
+// Rebuilds the grid from the obstacles. Every change made through this file
+// keeps it current; needed only after the obstacles were overwritten.
+void obstacles_rebuild_grid(obstacle_field_t *field);
+
+// Counts a ball hit; the obstacle breaks when it runs out of hit points.
+// Returns true if it was removed.
+bool obstacles_damage(obstacle_field_t *field, int index);
+
+void obstacles_remove(obstacle_field_t *field, int index);
+
+// Returns the index of an obstacle overlapping `box`, or -1. Only visits
+// the cells that `box` touches.
+int obstacles_hit_grid(const obstacle_field_t *field, rect_t box);
@@ -0,0 +1,163 @@
+#include "powerups.h"
+
+#include <string.h>
+
+#define HANDLE(slot, gen) ((powerup_handle_t)(((gen) << 8) | (slot)))
+#define HANDLE_SLOT(h) ((h) & 0xFF)
+#define HANDLE_GEN(h) ((h) >> 8)
+
+// At most one live timer per type exists after compaction.
+_Static_assert(EFFECT_HEAP_SIZE > POWERUP_TYPE_COUNT, "effect heap too small");
+_Static_assert(POWERUP_POOL_SIZE <= 0xFF, "slot index must fit the handle low byte");
+
+void powerups_clear(powerups_t *pu)
+{
+    // Keep entity generations so handles from the previous game stay stale.
+    for (int i = 0; i < POWERUP_POOL_SIZE; ++i) {
+        pu->pool[i].active = false;
+    }
+    pu->heap_len = 0;
+    memset(pu->effect_active, 0, sizeof(pu->effect_active));
+}
+
+powerup_handle_t powerups_spawn(powerups_t *pu, powerup_type_t type, int x, int y)
+{
+    for (int i = 0; i < POWERUP_POOL_SIZE; ++i) {
+        powerup_t *p = &pu->pool[i];
+        if (p->active) {
+            continue;
+        }
+        p->active = true;
+        p->type = (uint8_t)type;
+        p->x = (int16_t)x;
+        p->y = (int16_t)y;
+        return HANDLE(i, p->generation);
+    }
+    return POWERUP_HANDLE_NONE;
+}
+
+powerup_t *powerups_get(powerups_t *pu, powerup_handle_t handle)
+{
+    if (handle == POWERUP_HANDLE_NONE || HANDLE_SLOT(handle) >= POWERUP_POOL_SIZE) {
+        return NULL;
+    }
+    powerup_t *p = &pu->pool[HANDLE_SLOT(handle)];
+    if (!p->active || p->generation != HANDLE_GEN(handle)) {
+        return NULL;
+    }
+    return p;
+}
+
+void powerups_release(powerups_t *pu, powerup_handle_t handle)
+{
+    powerup_t *p = powerups_get(pu, handle);
+    if (p) {
+        p->active = false;
+        p->generation++;
+    }
+}
+
+powerup_handle_t powerups_handle(const powerups_t *pu, int slot)
+{
+    if (slot < 0 || slot >= POWERUP_POOL_SIZE || !pu->pool[slot].active) {
+        return POWERUP_HANDLE_NONE;
+    }
+    return HANDLE(slot, pu->pool[slot].generation);
+}
+
+static void heap_swap(effect_timer_t *a, effect_timer_t *b)
+{
+    effect_timer_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static void heap_sift_up(powerups_t *pu, int i)
+{
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (pu->heap[parent].expires <= pu->heap[i].expires) {
+            break;
+        }
+        heap_swap(&pu->heap[parent], &pu->heap[i]);
+        i = parent;
+    }
+}
+
+static void heap_sift_down(powerups_t *pu, int i)
+{
+    while (true) {
+        int left = 2 * i + 1;
+        int right = left + 1;
+        int smallest = i;
+        if (left < pu->heap_len && pu->heap[left].expires < pu->heap[smallest].expires) {
+            smallest = left;
+        }
+        if (right < pu->heap_len && pu->heap[right].expires < pu->heap[smallest].expires) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            return;
+        }
+        heap_swap(&pu->heap[smallest], &pu->heap[i]);
+        i = smallest;
+    }
+}
+
+static void heap_pop(powerups_t *pu)
+{
+    pu->heap[0] = pu->heap[--pu->heap_len];
+    heap_sift_down(pu, 0);
+}
+
+static bool timer_is_stale(const powerups_t *pu, const effect_timer_t *t)
+{
+    return t->generation != pu->effect_generation[t->type];
+}
+
+// Only reached when every slot is taken: drops superseded timers and re-heapifies.
+static void heap_compact(powerups_t *pu)
+{
+    int len = 0;
+    for (int i = 0; i < pu->heap_len; ++i) {
+        if (!timer_is_stale(pu, &pu->heap[i])) {
+            pu->heap[len++] = pu->heap[i];
+        }
+    }
+    pu->heap_len = (uint8_t)len;
+    for (int i = len / 2 - 1; i >= 0; --i) {
+        heap_sift_down(pu, i);
+    }
+}
+
+void powerups_start_effect(powerups_t *pu, powerup_type_t type, uint32_t now, uint32_t duration)
+{
+    pu->effect_generation[type]++;
+    pu->effect_active[type] = true;
+
+    if (pu->heap_len == EFFECT_HEAP_SIZE) {
+        heap_compact(pu);
+    }
+    int i = pu->heap_len++;
+    pu->heap[i] = (effect_timer_t) {
+        .expires = now + duration,
+        .type = (uint8_t)type,
+        .generation = pu->effect_generation[type],
+    };
+    heap_sift_up(pu, i);
+}
+
+unsigned powerups_expire(powerups_t *pu, uint32_t now)
+{
+    unsigned ended = 0;
+    while (pu->heap_len > 0 && pu->heap[0].expires <= now) {
+        effect_timer_t top = pu->heap[0];
+        heap_pop(pu);
+        if (timer_is_stale(pu, &top)) {
+            continue;
+        }
+        pu->effect_active[top.type] = false;
+        ended |= 1u << top.type;
+    }
+    return ended;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define POWERUP_POOL_SIZE 4
+#define POWERUP_SIZE 8
+#define EFFECT_HEAP_SIZE 8
+
+typedef enum {
+    POWERUP_WIDE_PADDLE,
+    POWERUP_SLOW_BALL,
+    POWERUP_EXTRA_HEART,
+    POWERUP_TYPE_COUNT
+} powerup_type_t;
+
+// Generation-counted handle: slot index in the low byte, generation in the
+// high byte. A handle goes stale as soon as its slot is released.
+typedef uint16_t powerup_handle_t;
+#define POWERUP_HANDLE_NONE 0xFFFF
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    uint8_t type;
+    uint8_t generation;
+    bool active;
+} powerup_t;
+
+typedef struct {
+    uint32_t expires;
+    uint8_t type;
+    uint8_t generation;
+} effect_timer_t;
+
+typedef struct {
+    powerup_t pool[POWERUP_POOL_SIZE];
+    // Min-heap of effect expiry ticks. Re-collecting an active effect bumps its
+    // generation and pushes a new timer; the old one is discarded when it surfaces.
+    effect_timer_t heap[EFFECT_HEAP_SIZE];
+    uint8_t heap_len;
+    uint8_t effect_generation[POWERUP_TYPE_COUNT];
+    bool effect_active[POWERUP_TYPE_COUNT];
+} powerups_t;
+
+void powerups_clear(powerups_t *pu);
+
+powerup_handle_t powerups_spawn(powerups_t *pu, powerup_type_t type, int x, int y);
+powerup_t *powerups_get(powerups_t *pu, powerup_handle_t handle);
+void powerups_release(powerups_t *pu, powerup_handle_t handle);
+powerup_handle_t powerups_handle(const powerups_t *pu, int slot);
+
+void powerups_start_effect(powerups_t *pu, powerup_type_t type, uint32_t now, uint32_t duration);
+
+// Pops timers that are due at `now`; returns a bit mask of effect types that ended.
+unsigned powerups_expire(powerups_t *pu, uint32_t now);
+
+static inline bool powerups_effect_active(const powerups_t *pu, powerup_type_t type)
+{
+    return pu->effect_active[type];
+}
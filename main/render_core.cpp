@@ -0,0 +1,85 @@
+#include "render_core.h"
+
+#include "game_config.h"
+#include "render_core.hpp"
+
+namespace {
+
+using Screen = render::Surface<SCREEN_W, RENDER_ROWS, render::Rgb565>;
+
+Screen s_screen(nullptr);
+
+template <int Rows>
+void glyph_rows(int x, int y, const uint8_t *bitmap, int scale, uint16_t color)
+{
+    switch (scale) {
+        case 1:
+            s_screen.glyph<1, Rows>(x, y, bitmap, color);
+            break;
+        case 2:
+            s_screen.glyph<2, Rows>(x, y, bitmap, color);
+            break;
+        case 3:
+            s_screen.glyph<3, Rows>(x, y, bitmap, color);
+            break;
+        default:
+            for (int r = 0; r < Rows; ++r) {
+                for (int col = 0; col < 8; ++col) {
+                    if (bitmap[r] & (0x80 >> col)) {
+                        s_screen.fill(x + col * scale, y + r * scale, scale, scale, color);
+                    }
+                }
+            }
+            break;
+    }
+}
+
+} // namespace
+
+extern "C" void render_bind(uint16_t *buffer, int origin_y)
+{
+    s_screen = Screen(buffer, origin_y);
+}
+
+extern "C" void render_clear(uint16_t color)
+{
+    if (s_screen.valid()) {
+        s_screen.clear(color);
+    }
+}
+
+extern "C" void render_fill(int x, int y, int w, int h, uint16_t color)
+{
+    if (s_screen.valid()) {
+        s_screen.fill(x, y, w, h, color);
+    }
+}
+
+extern "C" void render_fill_ball(int x, int y, uint16_t color)
+{
+    if (s_screen.valid()) {
+        s_screen.fill<BALL_SIZE, BALL_SIZE>(x, y, color);
+    }
+}
+
+extern "C" void render_glyph(int x, int y, const uint8_t *bitmap, int rows, int scale, uint16_t color)
+{
+    if (!s_screen.valid() || scale <= 0) {
+        return;
+    }
+    // Font glyphs have 8 rows and hearts 7; anything else is drawn in
+    // 8-row chunks.
+    if (rows == 7) {
+        glyph_rows<7>(x, y, bitmap, scale, color);
+        return;
+    }
+    for (int r = 0; r < rows; r += 8) {
+        if (rows - r >= 8) {
+            glyph_rows<8>(x, y + r * scale, bitmap + r, scale, color);
+        } else {
+            for (int rr = r; rr < rows; ++rr) {
+                glyph_rows<1>(x, y + rr * scale, bitmap + rr, scale, color);
+            }
+        }
+    }
+}
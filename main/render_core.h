@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C entry points into the templated core (render_core.hpp), instantiated for
+// a SCREEN_W x RENDER_ROWS RGB565 buffer. All of them ignore calls before a
+// buffer is bound.
+//
+// The buffer holds screen rows origin_y .. origin_y + RENDER_ROWS - 1; with a
+// full framebuffer origin_y is 0. Draw calls always take screen coordinates.
+void render_bind(uint16_t *buffer, int origin_y);
+void render_clear(uint16_t color);
+void render_fill(int x, int y, int w, int h, uint16_t color);
+void render_fill_ball(int x, int y, uint16_t color);
+
+// 8-pixel-wide 1bpp bitmap of `rows` rows, scaled. Scales 1-3 have
+// dedicated instantiations; others fall back to per-block fills.
+void render_glyph(int x, int y, const uint8_t *bitmap, int rows, int scale, uint16_t color);
+
+#ifdef __cplusplus
+}
+#endif
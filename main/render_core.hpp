@@ -0,0 +1,167 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Framebuffer rendering specialised at compile time. Screen size, pixel
+// format and glyph scale are template parameters, so inner loops have
+// constant trip counts and the bounds checks that a fixed size makes
+// redundant fold away. The C API in render_core.h instantiates these for
+// the configured screen.
+//
+// A surface may also cover only a horizontal strip of the screen: it then
+// holds H rows starting at screen row origin_y, draw calls take screen
+// coordinates and anything outside the strip is clipped away.
+
+namespace render {
+
+// Native RGB565 as stored in the framebuffer today.
+struct Rgb565 {
+    using storage = uint16_t;
+    static constexpr storage encode(uint16_t rgb565) { return rgb565; }
+};
+
+template <int W, int H, typename Format>
+class Surface {
+public:
+    using pixel_t = typename Format::storage;
+
+    static constexpr int width = W;
+    static constexpr int height = H;
+
+    constexpr explicit Surface(pixel_t *pixels, int origin_y = 0)
+        : pixels_(pixels), origin_y_(origin_y)
+    {
+    }
+
+    bool valid() const { return pixels_ != nullptr; }
+
+    void clear(uint16_t rgb565)
+    {
+        const pixel_t c = Format::encode(rgb565);
+        if (sizeof(pixel_t) == 2 && (W * H) % 2 == 0 && ((uintptr_t)pixels_ & 3) == 0) {
+            // Two pixels per store.
+            const uint32_t pair = (uint32_t)c | ((uint32_t)c << 16);
+            uint32_t *p = reinterpret_cast<uint32_t *>(pixels_);
+            for (int i = 0; i < W * H / 2; ++i) {
+                p[i] = pair;
+            }
+            return;
+        }
+        for (int i = 0; i < W * H; ++i) {
+            pixels_[i] = c;
+        }
+    }
+
+    // Runtime-sized fill, clipped once per call.
+    void fill(int x, int y, int w, int h, uint16_t rgb565)
+    {
+        fill_local(x, y - origin_y_, w, h, Format::encode(rgb565));
+    }
+
+    // Fixed-size fill: constant loops, and only a single bounds test on the
+    // common fully-visible path.
+    template <int RW, int RH>
+    void fill(int x, int y, uint16_t rgb565)
+    {
+        static_assert(RW > 0 && RH > 0 && RW <= W && RH <= H, "rect larger than the surface");
+        y -= origin_y_;
+        const pixel_t c = Format::encode(rgb565);
+        if (x < 0 || y < 0 || x > W - RW || y > H - RH) {
+            fill_local(x, y, RW, RH, c);
+            return;
+        }
+        pixel_t *row = pixels_ + y * W + x;
+        for (int yy = 0; yy < RH; ++yy, row += W) {
+            for (int xx = 0; xx < RW; ++xx) {
+                row[xx] = c;
+            }
+        }
+    }
+
+    // 8-pixel-wide 1bpp bitmap (MSB left), each bit drawn as a Scale x Scale
+    // block. Glyphs fully on screen skip clipping entirely and fill each
+    // run of set bits in a row as one span.
+    template <int Scale, int Rows>
+    void glyph(int x, int y, const uint8_t *bitmap, uint16_t rgb565)
+    {
+        static_assert(Scale > 0 && Rows > 0, "invalid glyph");
+        constexpr int gw = 8 * Scale;
+        constexpr int gh = Rows * Scale;
+        y -= origin_y_;
+        const pixel_t c = Format::encode(rgb565);
+        if (x >= 0 && y >= 0 && x <= W - gw && y <= H - gh) {
+            pixel_t *row = pixels_ + y * W + x;
+            for (int r = 0; r < Rows; ++r, row += Scale * W) {
+                unsigned bits = bitmap[r];
+                int col = 0;
+                while (bits & 0xFF) {
+                    while (!(bits & 0x80)) {
+                        bits <<= 1;
+                        ++col;
+                    }
+                    const int start = col;
+                    while (bits & 0x80) {
+                        bits <<= 1;
+                        ++col;
+                    }
+                    pixel_t *span = row + start * Scale;
+                    const int len = (col - start) * Scale;
+                    for (int sy = 0; sy < Scale; ++sy, span += W) {
+                        for (int i = 0; i < len; ++i) {
+                            span[i] = c;
+                        }
+                    }
+                }
+            }
+            return;
+        }
+        for (int r = 0; r < Rows; ++r) {
+            const uint8_t bits = bitmap[r];
+            for (int col = 0; col < 8; ++col) {
+                if (bits & (0x80 >> col)) {
+                    fill_local(x + col * Scale, y + r * Scale, Scale, Scale, c);
+                }
+            }
+        }
+    }
+
+private:
+    // Clipped fill in surface coordinates.
+    void fill_local(int x, int y, int w, int h, pixel_t c)
+    {
+        if (!clip(x, y, w, h)) {
+            return;
+        }
+        pixel_t *row = pixels_ + y * W + x;
+        for (int yy = 0; yy < h; ++yy, row += W) {
+            for (int xx = 0; xx < w; ++xx) {
+                row[xx] = c;
+            }
+        }
+    }
+
+    static bool clip(int &x, int &y, int &w, int &h)
+    {
+        if (x < 0) {
+            w += x;
+            x = 0;
+        }
+        if (y < 0) {
+            h += y;
+            y = 0;
+        }
+        if (x + w > W) {
+            w = W - x;
+        }
+        if (y + h > H) {
+            h = H - y;
+        }
+        return w > 0 && h > 0;
+    }
+
+    pixel_t *pixels_;
+    int origin_y_;
+};
+
+} // namespace render
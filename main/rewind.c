@@ -0,0 +1,383 @@
+#include "rewind.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_console.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mini_game.h"
+#include "sdkconfig.h"
+
+#define TAG "rewind"
+
+#ifdef CONFIG_PONG_REWIND_KB
+#define RING_BYTES (CONFIG_PONG_REWIND_KB * 1024)
+#else
+#define RING_BYTES (8 * 1024)
+#endif
+
+// Run headers. Short: 1sssslll, skip 0-15 and length 1-8. Long: a skip of
+// 0-127, then a length of 0-255.
+#define SHORT_RUN 0x80
+#define SHORT_SKIP_MAX 15
+#define SHORT_LEN_MAX 8
+#define SKIP_MAX 127
+#define RUN_MAX 255
+// Equal bytes a run bridges rather than starting a new one.
+#define RUN_GAP 1
+
+// Each record is framed by a length word in front, for dropping the oldest,
+// and behind, for walking back from the newest: (payload << 1) | keyframe,
+// one byte below 0x80, otherwise two with the high byte marked and on the
+// outside. A payload is at worst the state plus a header per RUN_MAX bytes.
+#define PAYLOAD_MAX 0x3FFF
+_Static_assert(GAME_ARENA_SIZE + 2 * (GAME_ARENA_SIZE / RUN_MAX + 1) <= PAYLOAD_MAX,
+               "record length word too small for the game arena");
+
+static uint8_t s_ring[RING_BYTES];
+// Records lie in [s_tail, s_head), or once writing has wrapped around, in
+// [s_tail, s_end) followed by [0, s_head).
+static size_t s_tail;
+static size_t s_head;
+static size_t s_end;
+static bool s_wrapped;
+static int s_records;
+// Records in the newest keyframe's group, the keyframe included.
+static int s_group_len;
+
+static uint8_t *s_state;
+static size_t s_size;
+// The newest record's keyframe, decoded.
+WORD_ALIGNED_ATTR static uint8_t s_key[GAME_ARENA_SIZE];
+
+static uint32_t s_recorded;
+static uint64_t s_recorded_bytes;
+static int64_t s_record_us;
+
+static size_t word_bytes(size_t word)
+{
+    return word < 0x80 ? 1 : 2;
+}
+
+static uint8_t *put_head(uint8_t *p, size_t word)
+{
+    if (word >= 0x80) {
+        *p++ = (uint8_t)(0x80 | (word >> 8));
+    }
+    *p++ = (uint8_t)word;
+    return p;
+}
+
+static uint8_t *put_tail(uint8_t *p, size_t word)
+{
+    *p++ = (uint8_t)word;
+    if (word >= 0x80) {
+        *p++ = (uint8_t)(0x80 | (word >> 8));
+    }
+    return p;
+}
+
+static size_t get_head(const uint8_t *p, size_t *word)
+{
+    if (p[0] & 0x80) {
+        *word = ((size_t)(p[0] & 0x7F) << 8) | p[1];
+        return 2;
+    }
+    *word = p[0];
+    return 1;
+}
+
+// Reads the word that ends right before `end`.
+static size_t get_tail(const uint8_t *end, size_t *word)
+{
+    if (end[-1] & 0x80) {
+        *word = ((size_t)(end[-1] & 0x7F) << 8) | end[-2];
+        return 2;
+    }
+    *word = end[-1];
+    return 1;
+}
+
+// Encodes where `a` and `b` differ as runs: a header with the number of
+// equal bytes since the previous run and the run length, then a ^ b for the
+// run. Skips too long for one header are split with empty runs. Equal words
+// are passed over four bytes at a time. With `out` NULL only the size is
+// returned.
+static size_t xor_encode(const uint8_t *a, const uint8_t *b, size_t size, uint8_t *out)
+{
+    size_t n = 0;
+    size_t last = 0;
+    size_t pos = 0;
+    while (pos < size) {
+        uint32_t wa;
+        uint32_t wb;
+        if (pos + 4 <= size) {
+            memcpy(&wa, a + pos, 4);
+            memcpy(&wb, b + pos, 4);
+            if (wa == wb) {
+                pos += 4;
+                continue;
+            }
+        }
+        if (a[pos] == b[pos]) {
+            pos++;
+            continue;
+        }
+        size_t start = pos;
+        size_t end = pos + 1;
+        for (size_t i = end; i < size && i - start < RUN_MAX; ++i) {
+            if (a[i] != b[i]) {
+                end = i + 1;
+            } else if (i + 1 - end > RUN_GAP) {
+                break;
+            }
+        }
+        size_t skip = start - last;
+        size_t len = end - start;
+        for (; skip > SKIP_MAX; skip -= SKIP_MAX, n += 2) {
+            if (out) {
+                out[n] = SKIP_MAX;
+                out[n + 1] = 0;
+            }
+        }
+        if (skip <= SHORT_SKIP_MAX && len <= SHORT_LEN_MAX) {
+            if (out) {
+                out[n] = (uint8_t)(SHORT_RUN | (skip << 3) | (len - 1));
+            }
+            n += 1;
+        } else {
+            if (out) {
+                out[n] = (uint8_t)skip;
+                out[n + 1] = (uint8_t)len;
+            }
+            n += 2;
+        }
+        if (out) {
+            for (size_t i = start; i < end; ++i) {
+                out[n + i - start] = a[i] ^ b[i];
+            }
+        }
+        n += len;
+        last = end;
+        pos = end;
+    }
+    return n;
+}
+
+static void xor_apply(uint8_t *dst, const uint8_t *runs, size_t len)
+{
+    size_t pos = 0;
+    for (size_t i = 0; i < len;) {
+        size_t run;
+        if (runs[i] & SHORT_RUN) {
+            pos += (runs[i] >> 3) & SHORT_SKIP_MAX;
+            run = (runs[i] & (SHORT_LEN_MAX - 1)) + 1;
+            i += 1;
+        } else {
+            pos += runs[i];
+            run = runs[i + 1];
+            i += 2;
+        }
+        for (size_t k = 0; k < run; ++k) {
+            dst[pos + k] ^= runs[i + k];
+        }
+        pos += run;
+        i += run;
+    }
+}
+
+static void drop_oldest(void)
+{
+    size_t word;
+    size_t n = get_head(&s_ring[s_tail], &word);
+    s_tail += 2 * n + (word >> 1);
+    s_records--;
+    if (s_wrapped && s_tail == s_end) {
+        s_tail = 0;
+        s_wrapped = false;
+    }
+    if (s_records == 0) {
+        s_tail = 0;
+        s_head = 0;
+    }
+}
+
+// A group's deltas are useless without its keyframe, so they go with it.
+static void drop_oldest_group(void)
+{
+    drop_oldest();
+    while (s_records > 0) {
+        size_t word;
+        get_head(&s_ring[s_tail], &word);
+        if (word & 1) {
+            break;
+        }
+        drop_oldest();
+    }
+}
+
+// Returns room for `size` contiguous bytes at s_head, wrapping to the start
+// of the ring and dropping the oldest groups as needed.
+static uint8_t *reserve(size_t size)
+{
+    while (true) {
+        if (!s_wrapped) {
+            if (RING_BYTES - s_head >= size) {
+                return &s_ring[s_head];
+            }
+            if (s_tail >= size) {
+                s_end = s_head;
+                s_head = 0;
+                s_wrapped = true;
+                return s_ring;
+            }
+        } else if (s_tail - s_head >= size) {
+            return &s_ring[s_head];
+        }
+        drop_oldest_group();
+    }
+}
+
+static bool write_record(bool keyframe)
+{
+    size_t payload = xor_encode(s_state, s_key, s_size, NULL);
+    size_t word = (payload << 1) | (keyframe ? 1 : 0);
+    size_t size = payload + 2 * word_bytes(word);
+    if (size > RING_BYTES) {
+        return false;
+    }
+    uint8_t *p = put_head(reserve(size), word);
+    xor_encode(s_state, s_key, s_size, p);
+    put_tail(p + payload, word);
+    s_head += size;
+    s_records++;
+    s_recorded_bytes += size;
+    return true;
+}
+
+// Records in the newest group, found by walking back to its keyframe.
+static int newest_group_len(void)
+{
+    size_t head = s_head;
+    bool wrapped = s_wrapped;
+    int count = 0;
+    while (count < s_records) {
+        if (wrapped && head == 0) {
+            head = s_end;
+            wrapped = false;
+        }
+        size_t word;
+        size_t n = get_tail(&s_ring[head], &word);
+        count++;
+        if (word & 1) {
+            break;
+        }
+        head -= 2 * n + (word >> 1);
+    }
+    return count;
+}
+
+void rewind_start(void *state, size_t size)
+{
+    if (size > sizeof(s_key)) {
+        ESP_LOGW(TAG, "State of %u bytes does not fit, rewind disabled", (unsigned)size);
+        s_state = NULL;
+        return;
+    }
+    s_state = state;
+    s_size = size;
+    s_tail = 0;
+    s_head = 0;
+    s_wrapped = false;
+    s_records = 0;
+    // The first keyframe has no predecessor and is held in s_key alone.
+    memcpy(s_key, s_state, s_size);
+    write_record(true);
+    s_group_len = 1;
+}
+
+void rewind_stop(void)
+{
+    s_state = NULL;
+    s_records = 0;
+}
+
+void rewind_record(void)
+{
+    if (!s_state) {
+        return;
+    }
+    int64_t start = esp_timer_get_time();
+    bool keyframe = s_group_len >= REWIND_KEYFRAME_TICKS;
+    // Keyframes are stored against the previous one, which stepping back
+    // recovers from them.
+    if (!write_record(keyframe)) {
+        // More change than the whole ring holds: start over from here.
+        rewind_start(s_state, s_size);
+    } else if (keyframe) {
+        memcpy(s_key, s_state, s_size);
+        s_group_len = 1;
+    } else {
+        s_group_len++;
+    }
+    s_recorded++;
+    s_record_us += esp_timer_get_time() - start;
+}
+
+bool rewind_step_back(void)
+{
+    if (!s_state || s_records < 2) {
+        return false;
+    }
+    size_t word;
+    size_t n = get_tail(&s_ring[s_head], &word);
+    size_t payload = word >> 1;
+    s_head -= 2 * n + payload;
+    s_records--;
+    bool keyframe = word & 1;
+    if (keyframe) {
+        xor_apply(s_key, &s_ring[s_head + n], payload);
+    }
+    if (s_wrapped && s_head == 0) {
+        s_head = s_end;
+        s_wrapped = false;
+    }
+
+    n = get_tail(&s_ring[s_head], &word);
+    payload = word >> 1;
+    memcpy(s_state, s_key, s_size);
+    if (!(word & 1)) {
+        xor_apply(s_state, &s_ring[s_head - n - payload], payload);
+    }
+    s_group_len = keyframe ? newest_group_len() : s_group_len - 1;
+    return true;
+}
+
+int rewind_steps(void)
+{
+    return s_records;
+}
+
+static int cmd_rewind(int argc, char **argv)
+{
+    size_t used = s_wrapped ? s_end - s_tail + s_head : s_head - s_tail;
+    printf("%d steps held in %u of %u bytes, state %u bytes\n", s_records, (unsigned)used, (unsigned)RING_BYTES,
+           (unsigned)s_size);
+    if (s_recorded) {
+        printf("%lu steps recorded, %lu bytes and %lu us per step on average\n", (unsigned long)s_recorded,
+               (unsigned long)(s_recorded_bytes / s_recorded), (unsigned long)(s_record_us / s_recorded));
+    }
+    return 0;
+}
+
+esp_err_t rewind_register_command(void)
+{
+    static const esp_console_cmd_t command = {
+        .command = "rewind",
+        .help = "Show how much play the rewind ring holds",
+        .func = cmd_rewind,
+    };
+    return esp_console_cmd_register(&command);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Rewind ring for practice play. After every simulation step the game's
+// state block is recorded as the bytes that differ from the current
+// keyframe, XORed, in a fixed-size byte ring. A keyframe is taken every
+// REWIND_KEYFRAME_TICKS steps and is itself stored as its XOR against the
+// previous keyframe, so only the newest keyframe is kept whole. Stepping
+// back restores a recorded step directly: copy the keyframe, apply one
+// delta; crossing a keyframe applies its delta to the keyframe first. The
+// oldest steps are dropped a keyframe group at a time as the ring fills.
+
+#define REWIND_KEYFRAME_TICKS 64
+
+// Starts recording `size` bytes at `state`, which must stay in place until
+// rewind_stop(). The current contents are the first step.
+void rewind_start(void *state, size_t size);
+void rewind_stop(void);
+
+// Records the state as the newest step.
+void rewind_record(void);
+
+// Restores the step before the newest one and drops the newest. Returns
+// false, leaving the state alone, when no earlier step is held.
+bool rewind_step_back(void);
+
+// Steps currently held.
+int rewind_steps(void);
+
+// Registers "rewind" on the console.
+esp_err_t rewind_register_command(void);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+// Small deterministic PRNG for gameplay. State must be non-zero.
+static inline uint32_t rng_next(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static inline int rng_range(uint32_t *state, int n)
+{
+    return (int)(rng_next(state) % (uint32_t)n);
+}
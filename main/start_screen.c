@@ -0,0 +1,33 @@
+#include "start_screen.h"
+
+#include <stdio.h>
+
+#include "display.h"
+#include "game_config.h"
+
+void start_screen_draw(const char *game_name, int highscore, int last_score)
+{
+    display_clear(COLOR_BLACK);
+
+    // Positions are fractions of the screen height, gaps grow with UI_SCALE.
+    char title[32];
+    snprintf(title, sizeof(title), "< %s >", game_name);
+    int title_scale = UI_SCALE + 1;
+    int title_y1 = SCREEN_H / 8;
+    int title_y2 = title_y1 + (8 * title_scale) + 4 * UI_SCALE;
+    draw_text_centered(title_y1, "Carl's", title_scale);
+    draw_text_centered(title_y2, title, title_scale);
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "HIGH:%d", highscore);
+    int info_scale = UI_SCALE + 1;
+    int info_y = title_y2 + (8 * title_scale) + 18 * UI_SCALE;
+    draw_text_centered(info_y, buf, info_scale);
+
+    if (last_score >= 0) {
+        snprintf(buf, sizeof(buf), "LETZTE:%d", last_score);
+        draw_text_centered(info_y + (8 * info_scale) + 6 * UI_SCALE, buf, UI_SCALE);
+    }
+
+    draw_text(SCREEN_W / 12, SCREEN_H - 20 * UI_SCALE, "PRESS BOOT", UI_SCALE);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// The launcher's start screen for `game_name`: title, highscore, the last
+// score unless it is negative, and the prompt. Clears and draws the frame
+// but leaves flushing to the caller, so the game loop can reveal it with a
+// transition and the benchmark suite can time it on the host.
+void start_screen_draw(const char *game_name, int highscore, int last_score);
@@ -0,0 +1,94 @@
+#include "state_hash.h"
+
+#include <string.h>
+
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#define TAG "hash"
+
+#ifdef CONFIG_PONG_STATE_HASH_EVERY
+#define LOG_EVERY CONFIG_PONG_STATE_HASH_EVERY
+#else
+#define LOG_EVERY 60
+#endif
+
+// Steps each scripted button choice is held, and the paddle_speed tunable's
+// default.
+#define SCRIPT_HOLD_STEPS 16
+#define SCRIPT_PADDLE_SPEED 3
+
+static const char *s_game;
+static uint32_t s_tick;
+static uint32_t s_logged_tick;
+static uint32_t s_state;
+static uint32_t s_input;
+
+uint32_t state_hash_bytes(uint32_t h, const void *data, size_t size)
+{
+    const uint8_t *p = data;
+    for (; size >= 4; p += 4, size -= 4) {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        h = state_hash_u32(h, v);
+    }
+    if (size) {
+        uint32_t v = 0;
+        memcpy(&v, p, size);
+        h = state_hash_u32(h, v);
+    }
+    return h;
+}
+
+static void log_tick(void)
+{
+    ESP_LOGI(TAG, "%s tick %lu state %08lx input %08lx", s_game, (unsigned long)s_tick, (unsigned long)s_state,
+             (unsigned long)s_input);
+    s_logged_tick = s_tick;
+}
+
+void state_hash_begin(const char *game, uint32_t seed)
+{
+    s_game = game;
+    s_tick = 0;
+    s_logged_tick = 0;
+    s_state = STATE_HASH_INIT;
+    s_input = STATE_HASH_INIT;
+    ESP_LOGI(TAG, "%s seed %08lx", game, (unsigned long)seed);
+}
+
+void state_hash_tick(uint32_t state, const game_input_t *input)
+{
+    if (!s_game) {
+        return;
+    }
+    s_state = state_hash_u32(s_state, state);
+    uint32_t buttons = (input->left ? 1u : 0) | (input->right ? 2u : 0);
+    s_input = state_hash_u32(s_input, buttons);
+    s_input = state_hash_u32(s_input, (uint32_t)input->analog_pos);
+    s_input = state_hash_u32(s_input, (uint32_t)input->paddle_speed);
+    s_tick++;
+    if (s_tick % LOG_EVERY == 0) {
+        log_tick();
+    }
+}
+
+void state_hash_end(void)
+{
+    if (s_game && s_tick != s_logged_tick) {
+        log_tick();
+    }
+    s_game = NULL;
+}
+
+game_input_t state_hash_script_input(uint32_t seed, uint32_t step)
+{
+    uint32_t h = state_hash_u32(state_hash_u32(STATE_HASH_INIT, seed), step / SCRIPT_HOLD_STEPS);
+    uint32_t choice = h % 3;
+    return (game_input_t) {
+        .left = choice == 1,
+        .right = choice == 2,
+        .analog_pos = -1,
+        .paddle_speed = SCRIPT_PADDLE_SPEED,
+    };
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mini_game.h"
+
+// Game state hashing for determinism checks. After every simulation step
+// the game's hash hook folds its state into a 32-bit hash, and a rolling
+// hash of those (and one of the inputs) is logged every few steps:
+//
+//   I (1234) hash: Pong seed 1f2e3d4c
+//   I (2234) hash: Pong tick 60 state 8a41c07e input 5d0b9f12
+//
+// Once a step differs every later line does, so tools/hashdiff.py finds the
+// first divergent step between two logs of the same seed and inputs. Games
+// hash fields rather than raw memory so that pointers and struct layout do
+// not matter and a host build hashes the same as the device. With
+// CONFIG_PONG_STATE_HASH_SCRIPT the device plays state_hash_script_input(),
+// and test/host's pong_replay logs the same run from the seed alone.
+
+#define STATE_HASH_INIT 0x811C9DC5u
+
+// Folds one value into `h` (the murmur3 round).
+static inline uint32_t state_hash_u32(uint32_t h, uint32_t v)
+{
+    v *= 0xCC9E2D51u;
+    v = (v << 15) | (v >> 17);
+    v *= 0x1B873593u;
+    h ^= v;
+    h = (h << 13) | (h >> 19);
+    return h * 5 + 0xE6546B64u;
+}
+
+// For arrays of plain integer fields without padding.
+uint32_t state_hash_bytes(uint32_t h, const void *data, size_t size);
+
+// Starts a run; the seed is logged so that a run can be repeated.
+void state_hash_begin(const char *game, uint32_t seed);
+
+// Folds in the hash of the state after a step and the input it was given.
+void state_hash_tick(uint32_t state, const game_input_t *input);
+
+// Logs the last step if it was not just logged.
+void state_hash_end(void);
+
+// The scripted input of step `step` in a run seeded with `seed`: left,
+// right or neither, held for a few steps at a time, at the default paddle
+// speed and without an analog paddle. Depends on nothing but its arguments.
+game_input_t state_hash_script_input(uint32_t seed, uint32_t step);
@@ -0,0 +1,198 @@
+#include "touch_paddle.h"
+
+#include "driver/touch_pad.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "input_sampler.h"
+#include "nvs.h"
+#include "sdkconfig.h"
+
+#define TAG "touch"
+
+#define PAD_COUNT 2
+
+// Measurement timing: ~1 ms sleep (150 kHz RTC clock) and ~0.5 ms charge
+// counting (8 MHz) per cycle, instead of the driver's ~27 ms default.
+#define TOUCH_SLEEP_CYCLES 150
+#define TOUCH_MEAS_CYCLES 0x1000
+
+// Driver IIR filter period; the filtered value is used for calibration and
+// release detection.
+#define TOUCH_FILTER_PERIOD_MS 5
+
+// Readings drop when touched. Press below 2/3 of the baseline, release
+// above 4/5 of it.
+#define PRESS_NUM 2
+#define PRESS_DEN 3
+#define RELEASE_NUM 4
+#define RELEASE_DEN 5
+
+// A stored baseline more than 20 % away from the current reading is stale.
+#define BASELINE_DRIFT_PCT 20
+#define CALIBRATION_SAMPLES 32
+
+#define RELEASE_POLL_US (5 * 1000)
+
+static const touch_pad_t s_pads[PAD_COUNT] = {
+    CONFIG_PONG_TOUCH_PAD_LEFT,
+    CONFIG_PONG_TOUCH_PAD_RIGHT,
+};
+static const input_button_t s_buttons[PAD_COUNT] = { INPUT_LEFT, INPUT_RIGHT };
+
+static uint16_t s_baseline[PAD_COUNT];
+// Pads currently pressed. The ISR sets bits and the release timer clears
+// them, possibly on the other core, so both go through s_lock.
+static uint32_t s_down;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t s_release_timer = NULL;
+
+static void IRAM_ATTR touch_isr(void *arg)
+{
+    uint32_t status = touch_pad_get_status();
+    touch_pad_clear_status();
+    int64_t now = esp_timer_get_time();
+    for (int i = 0; i < PAD_COUNT; ++i) {
+        uint32_t bit = 1u << i;
+        if (!(status & (1u << s_pads[i]))) {
+            continue;
+        }
+        portENTER_CRITICAL_ISR(&s_lock);
+        bool pressed = !(s_down & bit);
+        s_down |= bit;
+        portEXIT_CRITICAL_ISR(&s_lock);
+        if (pressed) {
+            input_sampler_inject(s_buttons[i], true, now);
+        }
+    }
+}
+
+// The ESP32 threshold interrupt only fires while a pad is touched, so
+// releases are detected by polling the filtered reading.
+static void release_poll(void *arg)
+{
+    for (int i = 0; i < PAD_COUNT; ++i) {
+        uint32_t bit = 1u << i;
+        portENTER_CRITICAL(&s_lock);
+        bool down = s_down & bit;
+        portEXIT_CRITICAL(&s_lock);
+        if (!down) {
+            continue;
+        }
+        uint16_t value = 0;
+        if (touch_pad_read_filtered(s_pads[i], &value) != ESP_OK) {
+            continue;
+        }
+        if (value > s_baseline[i] * RELEASE_NUM / RELEASE_DEN) {
+            // Release before clearing the bit: the ISR keeps firing while a
+            // pad is touched, so a touch in between is pressed by the next
+            // interrupt, after this release rather than before it.
+            input_sampler_inject(s_buttons[i], false, esp_timer_get_time());
+            portENTER_CRITICAL(&s_lock);
+            s_down &= ~bit;
+            portEXIT_CRITICAL(&s_lock);
+        }
+    }
+}
+
+static bool baseline_load(uint16_t baseline[PAD_COUNT])
+{
+    nvs_handle_t handle;
+    if (nvs_open("pong", NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    size_t len = sizeof(uint16_t) * PAD_COUNT;
+    esp_err_t err = nvs_get_blob(handle, "touch_base", baseline, &len);
+    nvs_close(handle);
+    return err == ESP_OK && len == sizeof(uint16_t) * PAD_COUNT;
+}
+
+static void baseline_save(const uint16_t baseline[PAD_COUNT])
+{
+    nvs_handle_t handle;
+    if (nvs_open("pong", NVS_READWRITE, &handle) == ESP_OK) {
+        nvs_set_blob(handle, "touch_base", baseline, sizeof(uint16_t) * PAD_COUNT);
+        nvs_commit(handle);
+        nvs_close(handle);
+    }
+}
+
+static void baseline_measure(uint16_t baseline[PAD_COUNT])
+{
+    uint32_t sum[PAD_COUNT] = { 0 };
+    for (int n = 0; n < CALIBRATION_SAMPLES; ++n) {
+        vTaskDelay(1);
+        for (int i = 0; i < PAD_COUNT; ++i) {
+            uint16_t value = 0;
+            touch_pad_read_filtered(s_pads[i], &value);
+            sum[i] += value;
+        }
+    }
+    for (int i = 0; i < PAD_COUNT; ++i) {
+        baseline[i] = (uint16_t)(sum[i] / CALIBRATION_SAMPLES);
+    }
+}
+
+static bool baseline_matches(const uint16_t stored[PAD_COUNT], const uint16_t current[PAD_COUNT])
+{
+    for (int i = 0; i < PAD_COUNT; ++i) {
+        int diff = (int)stored[i] - (int)current[i];
+        if (diff < 0) {
+            diff = -diff;
+        }
+        if (stored[i] == 0 || diff * 100 > stored[i] * BASELINE_DRIFT_PCT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t touch_paddle_start(void)
+{
+    esp_err_t err = touch_pad_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+    touch_pad_set_fsm_mode(TOUCH_FSM_MODE_TIMER);
+    touch_pad_set_voltage(TOUCH_HVOLT_2V7, TOUCH_LVOLT_0V5, TOUCH_HVOLT_ATTEN_1V);
+    touch_pad_set_meas_time(TOUCH_SLEEP_CYCLES, TOUCH_MEAS_CYCLES);
+    for (int i = 0; i < PAD_COUNT; ++i) {
+        touch_pad_config(s_pads[i], 0);
+    }
+    touch_pad_filter_start(TOUCH_FILTER_PERIOD_MS);
+
+    // Calibrate with nothing touching the pads, then keep the stored
+    // baseline as long as it still agrees with what we measure now.
+    uint16_t measured[PAD_COUNT];
+    baseline_measure(measured);
+    if (baseline_load(s_baseline) && baseline_matches(s_baseline, measured)) {
+        ESP_LOGI(TAG, "Using stored baseline L=%u R=%u", s_baseline[0], s_baseline[1]);
+    } else {
+        for (int i = 0; i < PAD_COUNT; ++i) {
+            s_baseline[i] = measured[i];
+        }
+        baseline_save(s_baseline);
+        ESP_LOGI(TAG, "Calibrated baseline L=%u R=%u", s_baseline[0], s_baseline[1]);
+    }
+
+    for (int i = 0; i < PAD_COUNT; ++i) {
+        touch_pad_set_thresh(s_pads[i], s_baseline[i] * PRESS_NUM / PRESS_DEN);
+    }
+    touch_pad_set_trigger_mode(TOUCH_TRIGGER_BELOW);
+    touch_pad_isr_register(touch_isr, NULL);
+    touch_pad_intr_enable();
+
+    const esp_timer_create_args_t args = {
+        .callback = release_poll,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "touch",
+        .skip_unhandled_events = true,
+    };
+    err = esp_timer_create(&args, &s_release_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return esp_timer_start_periodic(s_release_timer, RELEASE_POLL_US);
+}
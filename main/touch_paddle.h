@@ -0,0 +1,8 @@
+#pragma once
+
+#include "esp_err.h"
+
+// Capacitive touch pads acting as the left/right buttons. Presses arrive via
+// the touch threshold interrupt and are injected into the input sampler, so
+// button_update() sees them exactly like GPIO buttons.
+esp_err_t touch_paddle_start(void);
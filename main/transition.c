@@ -0,0 +1,204 @@
+#include "transition.h"
+
+#include "display.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#define TAG "transition"
+
+#ifdef CONFIG_PONG_STATIC_MEMORY
+#define ENABLE_STATIC_MEMORY 1
+#else
+#define ENABLE_STATIC_MEMORY 0
+#endif
+
+#define TILE_SIZE 16
+#define TILES_X ((SCREEN_W + TILE_SIZE - 1) / TILE_SIZE)
+#define TILES_Y ((SCREEN_H + TILE_SIZE - 1) / TILE_SIZE)
+#define TILE_COUNT (TILES_X * TILES_Y)
+
+// Revealed pixels are copied here and sent as one batch. Rows and columns
+// are split so that no window is larger than the whole buffer.
+#define STAGE_PIXELS (SCREEN_W * TILE_SIZE)
+#define STAGE_WINDOWS 32
+#define WIPE_ROWS (STAGE_PIXELS / SCREEN_W)
+#define SLIDE_COLS (STAGE_PIXELS / SCREEN_H)
+
+static uint16_t *s_stage;
+static SemaphoreHandle_t s_stage_free;
+// Set while a submitted batch may still be reading s_stage.
+static bool s_stage_busy;
+static display_window_t s_windows[STAGE_WINDOWS];
+static int s_window_count;
+static int s_stage_used;
+
+#if ENABLE_STATIC_MEMORY
+WORD_ALIGNED_ATTR static uint16_t s_stage_mem[STAGE_PIXELS];
+static StaticSemaphore_t s_stage_free_mem;
+#endif
+
+static bool s_active;
+static transition_kind_t s_kind;
+static int64_t s_start_us;
+static uint32_t s_duration_us;
+// Rows, columns or tiles, depending on the kind.
+static int s_units;
+static int s_revealed;
+static int s_tile_stride;
+
+static int gcd(int a, int b)
+{
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static bool stage_ready(void)
+{
+    if (s_stage) {
+        return true;
+    }
+#if ENABLE_STATIC_MEMORY
+    s_stage_free = xSemaphoreCreateBinaryStatic(&s_stage_free_mem);
+    s_stage = s_stage_mem;
+#else
+    s_stage_free = xSemaphoreCreateBinary();
+    s_stage = heap_caps_malloc(STAGE_PIXELS * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!s_stage_free || !s_stage) {
+        ESP_LOGW(TAG, "Transition buffer allocation failed, cutting instead");
+        heap_caps_free(s_stage);
+        s_stage = NULL;
+        return false;
+    }
+#endif
+    return true;
+}
+
+static void on_stage_sent(void *ctx)
+{
+    xSemaphoreGive(s_stage_free);
+}
+
+static void stage_submit(void)
+{
+    if (s_window_count == 0) {
+        return;
+    }
+    s_stage_busy = display_submit_batch(s_windows, s_window_count, on_stage_sent, NULL) == ESP_OK;
+    s_window_count = 0;
+    s_stage_used = 0;
+}
+
+static void stage_window(int x, int y, int w, int h)
+{
+    if (s_window_count == STAGE_WINDOWS || s_stage_used + w * h > STAGE_PIXELS) {
+        stage_submit();
+    }
+    if (s_stage_busy) {
+        xSemaphoreTake(s_stage_free, portMAX_DELAY);
+        s_stage_busy = false;
+    }
+    uint16_t *pixels = s_stage + s_stage_used;
+    display_read_rect(x, y, w, h, pixels);
+    s_windows[s_window_count++] = (display_window_t) {
+        .x = (int16_t)x,
+        .y = (int16_t)y,
+        .w = (int16_t)w,
+        .h = (int16_t)h,
+        .pixels = pixels,
+    };
+    s_stage_used += w * h;
+}
+
+static int min_int(int a, int b)
+{
+    return a < b ? a : b;
+}
+
+static void reveal(int from, int to)
+{
+    switch (s_kind) {
+        case TRANSITION_WIPE:
+            for (int y = from; y < to; y += WIPE_ROWS) {
+                stage_window(0, y, SCREEN_W, min_int(WIPE_ROWS, to - y));
+            }
+            break;
+        case TRANSITION_SLIDE:
+            for (int x = from; x < to; x += SLIDE_COLS) {
+                stage_window(x, 0, min_int(SLIDE_COLS, to - x), SCREEN_H);
+            }
+            break;
+        case TRANSITION_DISSOLVE:
+            for (int i = from; i < to; ++i) {
+                int tile = (int)(((int64_t)i * s_tile_stride) % TILE_COUNT);
+                int x = (tile % TILES_X) * TILE_SIZE;
+                int y = (tile / TILES_X) * TILE_SIZE;
+                stage_window(x, y, min_int(TILE_SIZE, SCREEN_W - x), min_int(TILE_SIZE, SCREEN_H - y));
+            }
+            break;
+        default:
+            break;
+    }
+    stage_submit();
+}
+
+void transition_start(transition_kind_t kind, uint32_t duration_us)
+{
+    if (kind == TRANSITION_CUT || duration_us == 0 || !stage_ready()) {
+        display_flush();
+        return;
+    }
+    s_kind = kind;
+    switch (kind) {
+        case TRANSITION_WIPE:
+            s_units = SCREEN_H;
+            break;
+        case TRANSITION_SLIDE:
+            s_units = SCREEN_W;
+            break;
+        default:
+            // Stepping by a stride coprime to the tile count visits every
+            // tile once, spread over the screen.
+            s_units = TILE_COUNT;
+            s_tile_stride = TILE_COUNT * 5 / 8;
+            while (gcd(s_tile_stride, TILE_COUNT) != 1) {
+                s_tile_stride++;
+            }
+            break;
+    }
+    s_revealed = 0;
+    s_duration_us = duration_us;
+    s_start_us = esp_timer_get_time();
+    s_active = true;
+}
+
+bool transition_step(void)
+{
+    if (!s_active) {
+        return false;
+    }
+    int64_t elapsed = esp_timer_get_time() - s_start_us;
+    int due = elapsed >= s_duration_us ? s_units : (int)(elapsed * s_units / s_duration_us);
+    if (due > s_revealed) {
+        reveal(s_revealed, due);
+        s_revealed = due;
+    }
+    if (s_revealed < s_units) {
+        return true;
+    }
+    s_active = false;
+    display_mark_presented();
+    return false;
+}
+
+bool transition_active(void)
+{
+    return s_active;
+}
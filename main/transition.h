@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Screen transitions. Instead of flushing a new screen in one go, the frame
+// drawn since the last flush is revealed over a fixed time: every step sends
+// only the part that became due since the previous one, as a batch of small
+// windows, so no frame pays for a full-screen transfer. Progress follows the
+// clock rather than a frame count, so a slow frame reveals a larger slice and
+// the duration holds.
+
+typedef enum {
+    TRANSITION_CUT,      // plain display_flush()
+    TRANSITION_WIPE,     // rows, top to bottom
+    TRANSITION_DISSOLVE, // 16x16 tiles in scrambled order
+    TRANSITION_SLIDE,    // columns, left to right
+} transition_kind_t;
+
+// Takes the place of display_flush(). Nothing may be drawn until the
+// transition has finished.
+void transition_start(transition_kind_t kind, uint32_t duration_us);
+
+// Sends whatever has become due. Returns true while the transition is still
+// running; the call that finishes it returns false.
+bool transition_step(void);
+
+bool transition_active(void);
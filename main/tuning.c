@@ -0,0 +1,234 @@
+#include "tuning.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_console.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "nvs.h"
+#include "wake.h"
+
+#define TAG "tuning"
+
+#define NVS_KEY "tunables"
+
+typedef struct {
+    const char *name;
+    size_t offset;
+    int32_t min;
+    int32_t max;
+    bool reboot;
+    const char *help;
+} tunable_desc_t;
+
+static const tunable_desc_t k_tunables[] = {
+#define TUNABLE_DESC(name, min, max, reboot, help) { #name, offsetof(tunables_t, name), min, max, reboot, help },
+    TUNABLES(TUNABLE_DESC)
+#undef TUNABLE_DESC
+};
+
+#define TUNABLE_COUNT (sizeof(k_tunables) / sizeof(k_tunables[0]))
+
+// The console task edits s_current; the game loop copies it out at frame
+// boundaries when s_dirty is set. Both are guarded by s_lock.
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static tunables_t s_current;
+static tunables_t s_defaults;
+static bool s_dirty;
+
+static int32_t *tunable_field(tunables_t *set, const tunable_desc_t *desc)
+{
+    return (int32_t *)((uint8_t *)set + desc->offset);
+}
+
+static int32_t tunable_get(const tunables_t *set, const tunable_desc_t *desc)
+{
+    return *(const int32_t *)((const uint8_t *)set + desc->offset);
+}
+
+static const tunable_desc_t *tunable_find(const char *name)
+{
+    for (size_t i = 0; i < TUNABLE_COUNT; ++i) {
+        if (strcmp(k_tunables[i].name, name) == 0) {
+            return &k_tunables[i];
+        }
+    }
+    return NULL;
+}
+
+static bool tunables_valid(const tunables_t *set)
+{
+    for (size_t i = 0; i < TUNABLE_COUNT; ++i) {
+        int32_t value = tunable_get(set, &k_tunables[i]);
+        if (value < k_tunables[i].min || value > k_tunables[i].max) {
+            return false;
+        }
+    }
+    return set->ball_max_speed >= set->ball_base_speed;
+}
+
+static tunables_t tunables_snapshot(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    tunables_t set = s_current;
+    portEXIT_CRITICAL(&s_lock);
+    return set;
+}
+
+static void tunables_publish(const tunables_t *set)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_current = *set;
+    s_dirty = true;
+    portEXIT_CRITICAL(&s_lock);
+    wake_post(WAKE_CONSOLE);
+}
+
+void tuning_init(const tunables_t *defaults)
+{
+    s_defaults = *defaults;
+    tunables_t set = *defaults;
+
+    nvs_handle_t handle;
+    if (nvs_open("pong", NVS_READONLY, &handle) == ESP_OK) {
+        tunables_t saved;
+        size_t len = sizeof(saved);
+        if (nvs_get_blob(handle, NVS_KEY, &saved, &len) == ESP_OK) {
+            if (len == sizeof(saved) && tunables_valid(&saved)) {
+                set = saved;
+                ESP_LOGI(TAG, "Loaded tuned values from NVS");
+            } else {
+                ESP_LOGW(TAG, "Ignoring stale tuned values in NVS");
+            }
+        }
+        nvs_close(handle);
+    }
+    tunables_publish(&set);
+}
+
+bool tuning_take(tunables_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    bool dirty = s_dirty;
+    if (dirty) {
+        *out = s_current;
+        s_dirty = false;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return dirty;
+}
+
+static void tunable_print(const tunables_t *set, const tunable_desc_t *desc)
+{
+    printf("%-16s %10ld  [%ld..%ld] %s%s\n", desc->name, (long)tunable_get(set, desc),
+           (long)desc->min, (long)desc->max, desc->help, desc->reboot ? " (after reboot)" : "");
+}
+
+static int cmd_get(int argc, char **argv)
+{
+    tunables_t set = tunables_snapshot();
+    if (argc < 2) {
+        for (size_t i = 0; i < TUNABLE_COUNT; ++i) {
+            tunable_print(&set, &k_tunables[i]);
+        }
+        return 0;
+    }
+    const tunable_desc_t *desc = tunable_find(argv[1]);
+    if (!desc) {
+        printf("unknown parameter '%s'\n", argv[1]);
+        return 1;
+    }
+    tunable_print(&set, desc);
+    return 0;
+}
+
+static int cmd_set(int argc, char **argv)
+{
+    if (argc != 3) {
+        printf("usage: set <name> <value>\n");
+        return 1;
+    }
+    const tunable_desc_t *desc = tunable_find(argv[1]);
+    if (!desc) {
+        printf("unknown parameter '%s'\n", argv[1]);
+        return 1;
+    }
+    char *end = NULL;
+    errno = 0;
+    long value = strtol(argv[2], &end, 0);
+    if (errno != 0 || end == argv[2] || *end != '\0') {
+        printf("'%s' is not a number\n", argv[2]);
+        return 1;
+    }
+
+    tunables_t set = tunables_snapshot();
+    *tunable_field(&set, desc) = (int32_t)value;
+    if (value < desc->min || value > desc->max || !tunables_valid(&set)) {
+        printf("%s must be in [%ld..%ld] and ball_max_speed >= ball_base_speed\n", desc->name,
+               (long)desc->min, (long)desc->max);
+        return 1;
+    }
+    tunables_publish(&set);
+    if (desc->reboot) {
+        printf("%s takes effect after 'save' and a reboot\n", desc->name);
+    }
+    return 0;
+}
+
+static int cmd_save(int argc, char **argv)
+{
+    tunables_t set = tunables_snapshot();
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open("pong", NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, NVS_KEY, &set, sizeof(set));
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (err != ESP_OK) {
+        printf("save failed: %s\n", esp_err_to_name(err));
+        return 1;
+    }
+    printf("saved\n");
+    return 0;
+}
+
+static int cmd_defaults(int argc, char **argv)
+{
+    tunables_publish(&s_defaults);
+    printf("defaults restored; 'save' to keep them\n");
+    return 0;
+}
+
+esp_err_t tuning_console_start(void)
+{
+    esp_console_repl_t *repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "pong>";
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    esp_err_t err = esp_console_new_repl_uart(&uart_config, &repl_config, &repl);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    static const esp_console_cmd_t commands[] = {
+        { .command = "get", .help = "Show all parameters or one", .hint = "[name]", .func = cmd_get },
+        { .command = "set", .help = "Change a parameter; applied at the next frame", .hint = "<name> <value>", .func = cmd_set },
+        { .command = "save", .help = "Store the current parameters in NVS", .func = cmd_save },
+        { .command = "defaults", .help = "Restore the built-in parameters", .func = cmd_defaults },
+    };
+    esp_console_register_help_command();
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); ++i) {
+        err = esp_console_cmd_register(&commands[i]);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return esp_console_start_repl(repl);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "difficulty.h"
+#include "esp_err.h"
+
+// Runtime-tunable parameters: name, min, max, applied after reboot, help.
+#define TUNABLES(X)                                                                  \
+    X(pclk_hz, 1000000, 80000000, true, "LCD SPI clock in Hz")                       \
+    X(sim_tick_us, 4000, 50000, false, "simulation step length in us")               \
+    X(frame_budget_us, 1000, 50000, false, "render + flush budget in us")            \
+    X(debounce_cycles, 0, 20, false, "frames a polled button must be stable")        \
+    X(paddle_speed, 1, 20, false, "paddle pixels per step")                          \
+    X(ball_base_speed, 1, 8, false, "serve speed")                                   \
+    X(ball_max_speed, 1, 8, false, "speed at the end of the ramp")                   \
+    X(ramp_hits, 1, DIFFICULTY_TABLE_LEN - 1, false, "hits until max speed")         \
+    X(curve, 0, CURVE_COUNT - 1, false, "difficulty curve (0 linear, 1 ease-in, 2 stepped)")
+
+typedef struct {
+#define TUNABLE_FIELD(name, min, max, reboot, help) int32_t name;
+    TUNABLES(TUNABLE_FIELD)
+#undef TUNABLE_FIELD
+} tunables_t;
+
+// Publishes the defaults, overridden by a set saved in NVS if there is one.
+void tuning_init(const tunables_t *defaults);
+
+// Copies the current set to *out if it changed since the last call. Call at
+// frame boundaries so a frame never sees a half-applied set.
+bool tuning_take(tunables_t *out);
+
+// Starts the "get" / "set" / "save" / "defaults" command console on UART0.
+esp_err_t tuning_console_start(void);
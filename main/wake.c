@@ -0,0 +1,141 @@
+#include "wake.h"
+
+#include <stdio.h>
+
+#include "esp_attr.h"
+#include "esp_console.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define TAG "wake"
+
+static TaskHandle_t s_loop_task;
+// One-shot that posts WAKE_FRAME: a tick timeout would round the frame
+// period to the 10 ms tick and wake the loop before the step is due.
+static esp_timer_handle_t s_frame_timer;
+
+// Written by the loop task only; the console reads them as they are.
+static uint32_t s_wakeups;
+static uint32_t s_reason_count[WAKE_REASON_COUNT];
+static int64_t s_started_us;
+static int64_t s_window_start_us;
+static uint32_t s_window_wakeups;
+static uint32_t s_rate;
+
+static const char *const k_reason_names[WAKE_REASON_COUNT] = { "input", "frame", "console" };
+
+static void frame_timer_fired(void *arg)
+{
+    wake_post(WAKE_FRAME);
+}
+
+void wake_init(void)
+{
+    s_started_us = esp_timer_get_time();
+    s_window_start_us = s_started_us;
+    s_loop_task = xTaskGetCurrentTaskHandle();
+
+    const esp_timer_create_args_t args = {
+        .callback = frame_timer_fired,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "frame",
+    };
+    if (esp_timer_create(&args, &s_frame_timer) != ESP_OK) {
+        ESP_LOGW(TAG, "Frame timer creation failed, waking on ticks");
+        s_frame_timer = NULL;
+    }
+}
+
+void IRAM_ATTR wake_post(uint32_t reasons)
+{
+    TaskHandle_t task = s_loop_task;
+    if (!task) {
+        return;
+    }
+    if (xPortInIsrContext()) {
+        BaseType_t woken = pdFALSE;
+        xTaskNotifyFromISR(task, reasons, eSetBits, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
+    } else {
+        xTaskNotify(task, reasons, eSetBits);
+    }
+}
+
+static void wake_count(uint32_t reasons)
+{
+    int64_t now = esp_timer_get_time();
+    s_wakeups++;
+    s_window_wakeups++;
+    for (int i = 0; i < WAKE_REASON_COUNT; ++i) {
+        if (reasons & (1u << i)) {
+            s_reason_count[i]++;
+        }
+    }
+    int64_t elapsed = now - s_window_start_us;
+    if (elapsed >= WAKE_RATE_WINDOW_S * 1000000LL) {
+        s_rate = (uint32_t)(s_window_wakeups * 1000000LL / elapsed);
+        s_window_wakeups = 0;
+        s_window_start_us = now;
+    }
+}
+
+uint32_t wake_wait(int64_t frame_us)
+{
+    uint32_t reasons = 0;
+    if (frame_us != WAKE_NO_FRAME && frame_us <= 0) {
+        // Already due: only collect what was posted meanwhile.
+        xTaskNotifyWait(0, UINT32_MAX, &reasons, 0);
+        reasons |= WAKE_FRAME;
+    } else if (frame_us == WAKE_NO_FRAME || s_frame_timer) {
+        bool timed = frame_us != WAKE_NO_FRAME;
+        if (timed) {
+            esp_timer_start_once(s_frame_timer, (uint64_t)frame_us);
+        }
+        xTaskNotifyWait(0, UINT32_MAX, &reasons, portMAX_DELAY);
+        if (timed) {
+            // A post that races this stop wakes the next wait early, which
+            // the loop sees as a frame without a step.
+            esp_timer_stop(s_frame_timer);
+        }
+    } else {
+        // Rounded up to whole ticks, so the step is due when the wait ends.
+        TickType_t ticks = (TickType_t)((frame_us * configTICK_RATE_HZ + 999999) / 1000000);
+        if (xTaskNotifyWait(0, UINT32_MAX, &reasons, ticks) != pdTRUE) {
+            reasons = WAKE_FRAME;
+        }
+    }
+    wake_count(reasons);
+    return reasons;
+}
+
+uint32_t wake_rate(void)
+{
+    return s_rate;
+}
+
+static int cmd_wakeups(int argc, char **argv)
+{
+    int64_t uptime_us = esp_timer_get_time() - s_started_us;
+    uint32_t wakeups = s_wakeups;
+    printf("%lu wakeups in %lld s, %lu/s on average, %lu/s over the last %d s\n", (unsigned long)wakeups,
+           (long long)(uptime_us / 1000000), uptime_us > 0 ? (unsigned long)(wakeups * 1000000LL / uptime_us) : 0ul,
+           (unsigned long)s_rate, WAKE_RATE_WINDOW_S);
+    for (int i = 0; i < WAKE_REASON_COUNT; ++i) {
+        printf("  %-8s %lu\n", k_reason_names[i], (unsigned long)s_reason_count[i]);
+    }
+    return 0;
+}
+
+esp_err_t wake_register_command(void)
+{
+    static const esp_console_cmd_t command = {
+        .command = "wakeups",
+        .help = "Show how often the game loop woke up, and why",
+        .func = cmd_wakeups,
+    };
+    return esp_console_cmd_register(&command);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Game loop wake-ups. The loop sleeps on its task notification and every
+// source that can change what it should do posts a reason bit; the frame
+// timer only runs while something on screen is moving, so static screens
+// take no CPU between events.
+
+#define WAKE_INPUT   (1u << 0) // button edge, touch press, debounced sampler change
+#define WAKE_FRAME   (1u << 1) // next simulation step is due
+#define WAKE_CONSOLE (1u << 2) // tuning change or benchmark request
+#define WAKE_REASON_COUNT 3
+
+// Pass as frame_us to sleep until an event arrives.
+#define WAKE_NO_FRAME (-1)
+
+#define WAKE_RATE_WINDOW_S 10
+
+// Called once from the game loop task; posts before that are dropped.
+void wake_init(void);
+
+// Safe from any task and from ISRs.
+void wake_post(uint32_t reasons);
+
+// Blocks until a reason is posted or, unless frame_us is WAKE_NO_FRAME,
+// until frame_us has passed. Returns the reasons, WAKE_FRAME on timeout.
+// The timeout runs on an esp_timer, so it is not rounded to whole ticks.
+uint32_t wake_wait(int64_t frame_us);
+
+// Wake-ups per second over the last completed WAKE_RATE_WINDOW_S.
+uint32_t wake_rate(void);
+
+// Registers "wakeups" on the console.
+esp_err_t wake_register_command(void);
@@ -0,0 +1,74 @@
+// The benchmark suite on the host: the same scenarios and JSON report as
+// the "bench" console command, against the null panel.
+//
+//   pong_bench [save|compare] [baseline file]
+//
+// Exits 0, 1 on errors, 2 on regressions, like the console command.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_suite.h"
+#include "display.h"
+#include "start_screen.h"
+
+#define DEFAULT_BASELINE "bench_baseline.bin"
+
+// What the device's bench command draws: Pong's start screen, flushed at
+// once rather than through a transition.
+static void bench_start_screen(void)
+{
+    start_screen_draw("Pong", 1234, 567);
+    display_flush();
+}
+
+static bool baseline_load(const char *path, bench_baseline_t *baseline)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    bool ok = fread(baseline, sizeof(*baseline), 1, f) == 1;
+    fclose(f);
+    return ok;
+}
+
+static bool baseline_save(const char *path, const bench_baseline_t *baseline)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    bool ok = fwrite(baseline, sizeof(*baseline), 1, f) == 1;
+    return fclose(f) == 0 && ok;
+}
+
+int main(int argc, char **argv)
+{
+    bool save = argc >= 2 && strcmp(argv[1], "save") == 0;
+    bool compare = argc >= 2 && strcmp(argv[1], "compare") == 0;
+    if (argc > 3 || (argc >= 2 && !save && !compare)) {
+        fprintf(stderr, "usage: %s [save|compare] [baseline file]\n", argv[0]);
+        return 1;
+    }
+    const char *path = argc == 3 ? argv[2] : DEFAULT_BASELINE;
+
+    bench_baseline_t baseline;
+    if (compare && !baseline_load(path, &baseline)) {
+        printf("{\"error\":\"no baseline in %s, run 'pong_bench save' first\"}\n", path);
+        return 1;
+    }
+
+    // The null panel from the start: display_init already flushes once.
+    display_set_null_panel(true);
+    display_init(0);
+
+    bench_baseline_t current;
+    int regressions = bench_suite_run(bench_start_screen, compare ? &baseline : NULL, &current);
+
+    if (save && !baseline_save(path, &current)) {
+        fprintf(stderr, "Saving baseline to %s failed\n", path);
+        return 1;
+    }
+    return regressions ? 2 : 0;
+}
@@ -0,0 +1,28 @@
+# Runs pong_replay twice with the same seed and has tools/hashdiff.py compare
+# the logs, which must match step for step.
+#
+#   cmake -DREPLAY=<pong_replay> -DPYTHON=<python3> -DHASHDIFF=<hashdiff.py>
+#         -DSEED=<hex> -DWORK_DIR=<dir> -P hashdiff_test.cmake
+
+foreach(var REPLAY PYTHON HASHDIFF SEED WORK_DIR)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} is not set")
+    endif()
+endforeach()
+
+foreach(run a b)
+    set(log "${WORK_DIR}/replay_${SEED}_${run}.log")
+    execute_process(COMMAND "${REPLAY}" "${SEED}"
+                    OUTPUT_FILE "${log}"
+                    RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "pong_replay ${SEED} failed: ${result}")
+    endif()
+endforeach()
+
+execute_process(COMMAND "${PYTHON}" "${HASHDIFF}"
+                        "${WORK_DIR}/replay_${SEED}_a.log" "${WORK_DIR}/replay_${SEED}_b.log"
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Two replays of seed ${SEED} diverged")
+endif()
@@ -0,0 +1,199 @@
+// Host implementations of the ESP-IDF calls display.c and the benchmark
+// suite make, for one thread and the null panel.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "esp_err.h"
+#include "esp_lcd_panel_vendor.h"
+#include "esp_timer.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+struct host_semaphore {
+    UBaseType_t count;
+    UBaseType_t max;
+};
+
+// Handles only need to be distinct and non-NULL.
+static int s_dummy_queue;
+static int s_dummy_task;
+static int s_dummy_io;
+static int s_dummy_panel;
+
+static void host_abort(const char *what)
+{
+    fprintf(stderr, "%s: not supported on the host, run with the null panel\n", what);
+    abort();
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    default:
+        return "ESP_FAIL";
+    }
+}
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    return (QueueHandle_t)&s_dummy_queue;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *mem)
+{
+    return (QueueHandle_t)&s_dummy_queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait)
+{
+    host_abort("xQueueSend");
+    return pdFALSE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait)
+{
+    host_abort("xQueueReceive");
+    return pdFALSE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial)
+{
+    SemaphoreHandle_t semaphore = malloc(sizeof(*semaphore));
+    if (semaphore) {
+        semaphore->count = initial;
+        semaphore->max = max;
+    }
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t max, UBaseType_t initial, StaticSemaphore_t *mem)
+{
+    return xSemaphoreCreateCounting(max, initial);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *mem)
+{
+    return xSemaphoreCreateBinary();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t wait)
+{
+    if (semaphore->count == 0) {
+        if (wait == 0) {
+            return pdFALSE;
+        }
+        // Nothing else runs that could give it.
+        host_abort("Blocking xSemaphoreTake");
+    }
+    semaphore->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    if (semaphore->count >= semaphore->max) {
+        return pdFALSE;
+    }
+    semaphore->count++;
+    return pdTRUE;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg, UBaseType_t priority,
+                       TaskHandle_t *ret_task)
+{
+    *ret_task = (TaskHandle_t)&s_dummy_task;
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                               UBaseType_t priority, StackType_t *stack, StaticTask_t *mem)
+{
+    return (TaskHandle_t)&s_dummy_task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    host_abort("vTaskNotifyGiveFromISR");
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait)
+{
+    host_abort("ulTaskNotifyTake");
+    return 0;
+}
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus, const esp_lcd_panel_io_spi_config_t *config,
+                                   esp_lcd_panel_io_handle_t *ret_io)
+{
+    *ret_io = (esp_lcd_panel_io_handle_t)&s_dummy_io;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_st7789(esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *config,
+                                   esp_lcd_panel_handle_t *ret_panel)
+{
+    *ret_panel = (esp_lcd_panel_handle_t)&s_dummy_panel;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_mirror(esp_lcd_panel_handle_t panel, bool mirror_x, bool mirror_y)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_swap_xy(esp_lcd_panel_handle_t panel, bool swap_axes)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_set_gap(esp_lcd_panel_handle_t panel, int x_gap, int y_gap)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel, bool on)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                    const void *color_data)
+{
+    host_abort("esp_lcd_panel_draw_bitmap");
+    return ESP_FAIL;
+}
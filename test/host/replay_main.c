@@ -0,0 +1,110 @@
+// Replays the scripted input of a CONFIG_PONG_STATE_HASH_SCRIPT build on the
+// host and logs the same "hash:" lines the device does, so tools/hashdiff.py
+// can compare a device log with a host one, or two host builds.
+//
+//   pong_replay <seed hex> [game ...]
+//
+// Plays every game in launcher order unless games are named. Exits 0, 1 on
+// errors.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "mini_game.h"
+#include "sdkconfig.h"
+#include "state_hash.h"
+
+// Every game is over long before this with scripted input; a run that is not
+// is reported rather than looping forever.
+#define MAX_STEPS (10 * 1000 * 1000)
+
+// The launcher's games, in its order.
+static const mini_game_t *const k_games[] = {
+    &g_game_pong,
+#ifdef CONFIG_PONG_OBSTACLE_MODE
+    &g_game_obstacles,
+#endif
+    &g_game_catch,
+};
+
+#define GAME_COUNT ((int)(sizeof(k_games) / sizeof(k_games[0])))
+
+static uint8_t s_arena_buffer[GAME_ARENA_SIZE] __attribute__((aligned(ARENA_ALIGN)));
+
+static const mini_game_t *find_game(const char *name)
+{
+    for (int i = 0; i < GAME_COUNT; ++i) {
+        if (strcmp(k_games[i]->name, name) == 0) {
+            return k_games[i];
+        }
+    }
+    return NULL;
+}
+
+// What the launcher does between starting and leaving a game, without
+// rendering or pausing.
+static bool replay(const mini_game_t *game, arena_t *arena, uint32_t seed)
+{
+    void *state = game->init(arena, seed);
+    if (!state) {
+        fprintf(stderr, "%s does not fit the %u byte arena\n", game->name, (unsigned)arena->size);
+        arena_reset(arena);
+        return false;
+    }
+    state_hash_begin(game->name, seed);
+    uint32_t step = 0;
+    bool alive = true;
+    while (alive && step < MAX_STEPS) {
+        game_input_t input = state_hash_script_input(seed, step);
+        alive = game->tick(state, &input);
+        step++;
+        state_hash_tick(game->hash(state), &input);
+    }
+    state_hash_end();
+    if (game->teardown) {
+        game->teardown(state);
+    }
+    arena_reset(arena);
+    if (alive) {
+        fprintf(stderr, "%s still running after %u steps\n", game->name, (unsigned)MAX_STEPS);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    char *end = NULL;
+    unsigned long seed = argc >= 2 ? strtoul(argv[1], &end, 16) : 0;
+    if (argc < 2 || argc > 2 + GAME_COUNT || *end != '\0' || seed > UINT32_MAX) {
+        fprintf(stderr, "usage: %s <seed hex> [game ...]\n", argv[0]);
+        return 1;
+    }
+
+    const mini_game_t *games[GAME_COUNT];
+    int count = 0;
+    if (argc == 2) {
+        memcpy(games, k_games, sizeof(k_games));
+        count = GAME_COUNT;
+    }
+    for (int i = 2; i < argc; ++i) {
+        const mini_game_t *game = find_game(argv[i]);
+        if (!game) {
+            fprintf(stderr, "%s: no such game\n", argv[i]);
+            return 1;
+        }
+        games[count++] = game;
+    }
+
+    arena_t arena;
+    arena_init(&arena, s_arena_buffer, sizeof(s_arena_buffer));
+    for (int i = 0; i < count; ++i) {
+        if (!replay(games[i], &arena, (uint32_t)seed)) {
+            return 1;
+        }
+    }
+    return 0;
+}
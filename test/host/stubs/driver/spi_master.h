@@ -0,0 +1,21 @@
+#pragma once
+
+#include "esp_err.h"
+
+typedef enum { SPI2_HOST = 1 } spi_host_device_t;
+typedef enum { SPI_DMA_CH_AUTO = 3 } spi_dma_chan_t;
+
+typedef struct {
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+} spi_bus_config_t;
+
+static inline esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *config,
+                                           spi_dma_chan_t dma)
+{
+    return ESP_OK;
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+#define IRAM_ATTR
+#define WORD_ALIGNED_ATTR __attribute__((aligned(4)))
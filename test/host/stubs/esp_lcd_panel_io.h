@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef int esp_lcd_spi_bus_handle_t;
+
+typedef struct {
+    void *reserved;
+} esp_lcd_panel_io_event_data_t;
+
+typedef bool (*esp_lcd_panel_io_color_trans_done_cb_t)(esp_lcd_panel_io_handle_t io,
+                                                        esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+
+typedef struct {
+    int cs_gpio_num;
+    int dc_gpio_num;
+    int spi_mode;
+    unsigned pclk_hz;
+    int trans_queue_depth;
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    int lcd_cmd_bits;
+    int lcd_param_bits;
+} esp_lcd_panel_io_spi_config_t;
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus, const esp_lcd_panel_io_spi_config_t *config,
+                                   esp_lcd_panel_io_handle_t *ret_io);
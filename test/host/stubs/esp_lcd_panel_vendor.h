@@ -0,0 +1,18 @@
+#pragma once
+
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+
+typedef enum {
+    ESP_LCD_COLOR_SPACE_RGB,
+    ESP_LCD_COLOR_SPACE_BGR,
+} esp_lcd_color_space_t;
+
+typedef struct {
+    int reset_gpio_num;
+    esp_lcd_color_space_t color_space;
+    unsigned bits_per_pixel;
+} esp_lcd_panel_dev_config_t;
+
+esp_err_t esp_lcd_new_panel_st7789(esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *config,
+                                   esp_lcd_panel_handle_t *ret_panel);
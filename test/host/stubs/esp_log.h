@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdio.h>
+
+// Errors and warnings go to stderr; the tests print their own results.
+// Info and debug lines are compiled, so their arguments stay checked, but
+// not printed; pong_replay sets HOST_LOG_INFO to print info lines, which
+// hold the state hashes.
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#ifdef HOST_LOG_INFO
+#define ESP_LOGI(tag, fmt, ...) printf("I %s: " fmt "\n", tag, ##__VA_ARGS__)
+#else
+#define ESP_LOGI(tag, fmt, ...) do { if (0) printf("%s: " fmt "\n", tag, ##__VA_ARGS__); } while (0)
+#endif
+#define ESP_LOGD(tag, fmt, ...) do { if (0) printf("%s: " fmt "\n", tag, ##__VA_ARGS__); } while (0)
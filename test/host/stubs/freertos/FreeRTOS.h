@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "sdkconfig.h"
+
+// Just enough FreeRTOS for display.c and the benchmark suite on one host
+// thread. Nothing ever blocks: a take that would wait aborts instead, as
+// no other task could give it.
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define configTICK_RATE_HZ CONFIG_FREERTOS_HZ
+#define pdMS_TO_TICKS(ms) ((TickType_t)((uint64_t)(ms) * configTICK_RATE_HZ / 1000))
+
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+typedef struct {
+    uint8_t storage[96];
+} StaticQueue_t;
+typedef struct {
+    uint8_t storage[96];
+} StaticTask_t;
+typedef struct {
+    uint8_t storage[96];
+} StaticSemaphore_t;
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+// Tasks are created but never run.
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg, UBaseType_t priority,
+                       TaskHandle_t *ret_task);
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                               UBaseType_t priority, StackType_t *stack, StaticTask_t *mem);
+void vTaskDelay(TickType_t ticks);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
@@ -0,0 +1,21 @@
+#pragma once
+
+// Host configuration for the tests: the 240x135 panel and the Kconfig
+// defaults for everything the simulation reads.
+
+#define CONFIG_PONG_SCREEN_WIDTH 240
+#define CONFIG_PONG_SCREEN_HEIGHT 135
+#define CONFIG_PONG_BALL_SIZE 4
+#define CONFIG_PONG_PADDLE_MIN_WIDTH 32
+#define CONFIG_PONG_DIFFICULTY_LINEAR 1
+#define CONFIG_PONG_DIFFICULTY_STEP_HITS 25
+#define CONFIG_PONG_OBSTACLE_COUNT 200
+#define CONFIG_PONG_POWERUPS 1
+#define CONFIG_PONG_STATE_HASH_EVERY 60
+
+// The panel behind the benchmark suite, which only ever sees the null
+// sink. CMakeLists.txt picks the renderer.
+#define CONFIG_PONG_LCD_RST_GPIO -1
+#define CONFIG_PONG_LCD_OFFSET_X 40
+#define CONFIG_PONG_LCD_OFFSET_Y 53
+#define CONFIG_FREERTOS_HZ 100
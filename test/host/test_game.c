@@ -0,0 +1,332 @@
+// Unit and property tests for game_step(): walls, paddle bounces, miss
+// accounting and the speed ramp, then invariants checked over millions of
+// random states. These are the safety net for any rewrite of the physics.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "difficulty.h"
+#include "game.h"
+#include "rng.h"
+#include "unity.h"
+
+// Same as game.c: the paddle's top edge.
+#define PADDLE_Y (SCREEN_H - PADDLE_H - 2)
+
+// Random states per property test; FUZZ_STATES and FUZZ_SEED override.
+// Obstacle states each generate a field, so they run a tenth as many.
+#define FUZZ_STATES 1000000
+#define FUZZ_STEPS 16
+#define FUZZ_SEED 0x5EED1234u
+
+static game_t s_game;
+static obstacle_field_t s_field;
+
+void setUp(void)
+{
+    difficulty_set_curve(CURVE_LINEAR);
+    memset(&s_game, 0, sizeof(s_game));
+    game_reset(&s_game, 1);
+}
+
+void tearDown(void)
+{
+}
+
+static long env_or(const char *name, long fallback)
+{
+    const char *value = getenv(name);
+    return value ? strtol(value, NULL, 0) : fallback;
+}
+
+static void ball_place(int x, int y, int vx, int vy)
+{
+    s_game.ball = (ball_t) { x, y, vx, vy };
+}
+
+static int ball_speed_sq(const ball_t *ball)
+{
+    return ball->vx * ball->vx + ball->vy * ball->vy;
+}
+
+static int level_speed_sq(int hits)
+{
+    int v = difficulty_for_hits(hits)->speed * BALL_DIR_ONE;
+    return v * v;
+}
+
+// Puts the ball one step above the paddle line, moving straight down, with
+// its left edge at x pixels.
+static void ball_above_paddle_line(int x)
+{
+    ball_place(TO_SUBPX(x), TO_SUBPX(PADDLE_Y - BALL_SIZE) - 30, 51, 68);
+}
+
+static void test_reset_serves_from_the_top_centre(void)
+{
+    const ball_t *ball = &s_game.ball;
+    TEST_ASSERT_EQUAL_INT(TO_SUBPX(SCREEN_W / 2), ball->x);
+    TEST_ASSERT_EQUAL_INT(0, ball->y);
+    TEST_ASSERT_GREATER_THAN(0, ball->vx);
+    TEST_ASSERT_GREATER_THAN(0, ball->vy);
+    TEST_ASSERT_EQUAL_INT(level_speed_sq(0), ball_speed_sq(ball));
+    TEST_ASSERT_EQUAL_INT(difficulty_for_hits(0)->paddle_w, s_game.paddle.w);
+    TEST_ASSERT_EQUAL_INT(SCREEN_W / 2 - s_game.paddle.w / 2, s_game.paddle.x);
+    TEST_ASSERT_EQUAL_INT(0, s_game.hits);
+    TEST_ASSERT_EQUAL_INT(0, s_game.misses);
+    TEST_ASSERT_EQUAL_INT(MAX_LIVES, game_lives(&s_game));
+}
+
+static void test_left_wall_reflects_and_clamps(void)
+{
+    ball_place(20, TO_SUBPX(50), -51, 68);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(0, s_game.ball.x);
+    TEST_ASSERT_EQUAL_INT(TO_SUBPX(50) + 68, s_game.ball.y);
+    TEST_ASSERT_EQUAL_INT(51, s_game.ball.vx);
+    TEST_ASSERT_EQUAL_INT(68, s_game.ball.vy);
+}
+
+static void test_right_wall_reflects_and_clamps(void)
+{
+    ball_place(TO_SUBPX(SCREEN_W - BALL_SIZE) - 20, TO_SUBPX(50), 51, -68);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(TO_SUBPX(SCREEN_W - BALL_SIZE), s_game.ball.x);
+    TEST_ASSERT_EQUAL_INT(TO_SUBPX(50) - 68, s_game.ball.y);
+    TEST_ASSERT_EQUAL_INT(-51, s_game.ball.vx);
+    TEST_ASSERT_EQUAL_INT(-68, s_game.ball.vy);
+}
+
+static void test_top_wall_reflects_and_clamps(void)
+{
+    ball_place(TO_SUBPX(100), 30, 51, -68);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(0, s_game.ball.y);
+    TEST_ASSERT_EQUAL_INT(68, s_game.ball.vy);
+    TEST_ASSERT_EQUAL_INT(51, s_game.ball.vx);
+}
+
+static void test_paddle_hit_bounces_the_ball_back_up(void)
+{
+    s_game.paddle.x = 100;
+    ball_above_paddle_line(s_game.paddle.x + s_game.paddle.w / 2);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(1, s_game.hits);
+    TEST_ASSERT_EQUAL_INT(0, s_game.misses);
+    TEST_ASSERT_EQUAL_INT(TO_SUBPX(PADDLE_Y - BALL_SIZE - 1), s_game.ball.y);
+    TEST_ASSERT_LESS_THAN(0, s_game.ball.vy);
+}
+
+static void test_paddle_edges_still_hit(void)
+{
+    s_game.paddle.x = 100;
+    // Overlapping the paddle's left end, then its right end, by one pixel.
+    ball_above_paddle_line(s_game.paddle.x - BALL_SIZE);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(1, s_game.hits);
+    TEST_ASSERT_LESS_THAN(0, s_game.ball.vx);
+
+    ball_above_paddle_line(s_game.paddle.x + s_game.paddle.w);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(2, s_game.hits);
+    TEST_ASSERT_GREATER_THAN(0, s_game.ball.vx);
+    TEST_ASSERT_EQUAL_INT(0, s_game.misses);
+}
+
+static void test_ball_below_the_paddle_line_is_not_missed_yet(void)
+{
+    s_game.paddle.x = 0;
+    ball_above_paddle_line(200);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(0, s_game.hits);
+    TEST_ASSERT_EQUAL_INT(0, s_game.misses);
+    TEST_ASSERT_GREATER_THAN(0, s_game.ball.vy);
+}
+
+static void test_miss_counts_and_serves_again(void)
+{
+    s_game.paddle.x = 0;
+    ball_place(TO_SUBPX(200), TO_SUBPX(SCREEN_H - BALL_SIZE) - 30, 51, 68);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(1, s_game.misses);
+    TEST_ASSERT_EQUAL_INT(0, s_game.hits);
+    TEST_ASSERT_EQUAL_INT(MAX_LIVES - 1, game_lives(&s_game));
+    TEST_ASSERT_EQUAL_INT(TO_SUBPX(SCREEN_W / 2), s_game.ball.x);
+    TEST_ASSERT_EQUAL_INT(0, s_game.ball.y);
+    TEST_ASSERT_GREATER_THAN(0, s_game.ball.vy);
+    // Served back towards the side the ball came from.
+    TEST_ASSERT_LESS_THAN(0, s_game.ball.vx);
+}
+
+static void test_lives_run_out_after_max_lives_misses(void)
+{
+    s_game.paddle.x = 0;
+    s_game.bonus_lives = 1;
+    for (int i = 0; i < MAX_LIVES + 1; ++i) {
+        TEST_ASSERT_GREATER_THAN(0, game_lives(&s_game));
+        ball_place(TO_SUBPX(200), TO_SUBPX(SCREEN_H - BALL_SIZE) - 30, 51, 68);
+        game_step(&s_game);
+    }
+    TEST_ASSERT_EQUAL_INT(MAX_LIVES + 1, s_game.misses);
+    TEST_ASSERT_EQUAL_INT(0, game_lives(&s_game));
+}
+
+static void test_speed_ramps_with_hits(void)
+{
+    for (int curve = 0; curve < CURVE_COUNT; ++curve) {
+        difficulty_set_curve((difficulty_curve_t)curve);
+        TEST_ASSERT_EQUAL_INT(BALL_BASE_SPEED, difficulty_for_hits(0)->speed);
+        TEST_ASSERT_EQUAL_INT(BALL_MAX_SPEED, difficulty_for_hits(DIFFICULTY_RAMP_HITS)->speed);
+        // Hits past the table reuse its plateau.
+        TEST_ASSERT_EQUAL_INT(BALL_MAX_SPEED, difficulty_for_hits(DIFFICULTY_TABLE_LEN + 100)->speed);
+        for (int hits = 1; hits < DIFFICULTY_TABLE_LEN; ++hits) {
+            TEST_ASSERT_GREATER_OR_EQUAL(difficulty_for_hits(hits - 1)->speed, difficulty_for_hits(hits)->speed);
+            TEST_ASSERT_LESS_OR_EQUAL(difficulty_for_hits(hits - 1)->paddle_w, difficulty_for_hits(hits)->paddle_w);
+        }
+    }
+}
+
+static void test_paddle_hit_takes_the_speed_of_the_new_hit_count(void)
+{
+    s_game.hits = DIFFICULTY_RAMP_HITS - 1;
+    s_game.paddle.x = 100;
+    ball_above_paddle_line(110);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(DIFFICULTY_RAMP_HITS, s_game.hits);
+    TEST_ASSERT_EQUAL_INT(level_speed_sq(DIFFICULTY_RAMP_HITS), ball_speed_sq(&s_game.ball));
+}
+
+static void test_serve_after_a_miss_is_at_base_speed(void)
+{
+    s_game.hits = DIFFICULTY_RAMP_HITS;
+    s_game.paddle.x = 0;
+    ball_place(TO_SUBPX(200), TO_SUBPX(SCREEN_H - BALL_SIZE) - 30, 3 * 51, 3 * 68);
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(1, s_game.misses);
+    TEST_ASSERT_EQUAL_INT(level_speed_sq(0), ball_speed_sq(&s_game.ball));
+}
+
+// A state the game could be in, or close to it: any ball position and
+// velocity, paddle anywhere, hits and misses within their ranges.
+static void random_state(game_t *game, uint32_t *rng, bool powerups, obstacle_field_t *field)
+{
+    game_reset(game, rng_next(rng));
+    game->powerups_enabled = powerups;
+    game->obstacles = field;
+    if (field) {
+        obstacles_generate(field, 1 + rng_range(rng, OBSTACLE_MAX), rng_next(rng));
+    }
+    game->hits = rng_range(rng, DIFFICULTY_TABLE_LEN + 32);
+    game->bonus_lives = rng_range(rng, MAX_BONUS_LIVES + 1);
+    game->misses = rng_range(rng, MAX_LIVES + game->bonus_lives);
+    game->paddle.w = difficulty_for_hits(game->hits)->paddle_w;
+    game->paddle.x = rng_range(rng, SCREEN_W - game->paddle.w + 1);
+
+    int v_max = BALL_MAX_SPEED * BALL_DIR_ONE;
+    ball_t *ball = &game->ball;
+    ball->x = rng_range(rng, TO_SUBPX(SCREEN_W - BALL_SIZE) + 1);
+    ball->y = rng_range(rng, TO_SUBPX(SCREEN_H - BALL_SIZE) + 1);
+    do {
+        ball->vx = rng_range(rng, 2 * v_max + 1) - v_max;
+        ball->vy = rng_range(rng, 2 * v_max + 1) - v_max;
+    } while (ball->vx == 0 && ball->vy == 0);
+}
+
+// Checks one step; returns what broke, or NULL.
+static const char *step_broke(const game_t *before, const game_t *after)
+{
+    const ball_t *ball = &after->ball;
+    if (ball->x < 0 || ball->x > TO_SUBPX(SCREEN_W - BALL_SIZE) || ball->y < 0 ||
+        ball->y > TO_SUBPX(SCREEN_H - BALL_SIZE)) {
+        return "ball left the field";
+    }
+    if (ball->vx == 0 && ball->vy == 0) {
+        return "ball stopped";
+    }
+    if (after->hits < before->hits || after->hits > before->hits + 1) {
+        return "hits did not go up by at most one";
+    }
+    if (after->misses < before->misses || after->misses > before->misses + 1) {
+        return "misses did not go up by at most one";
+    }
+    if (after->misses > MAX_LIVES + after->bonus_lives) {
+        return "more misses than lives";
+    }
+    if (after->paddle.x < 0 || after->paddle.x > SCREEN_W - after->paddle.w) {
+        return "paddle left the field";
+    }
+    // Walls and obstacles only flip signs; hits and serves set the level's
+    // speed exactly.
+    int expected = ball_speed_sq(&before->ball);
+    if (after->misses != before->misses) {
+        expected = level_speed_sq(0);
+    } else if (after->hits != before->hits) {
+        expected = level_speed_sq(after->hits);
+    }
+    if (ball_speed_sq(ball) != expected) {
+        return "ball speed changed";
+    }
+    return NULL;
+}
+
+static void fuzz(long states, bool powerups, obstacle_field_t *field)
+{
+    uint32_t seed = (uint32_t)env_or("FUZZ_SEED", FUZZ_SEED);
+    uint32_t rng = seed ? seed : 1;
+    for (long n = 0; n < states; ++n) {
+        random_state(&s_game, &rng, powerups, field);
+        for (int step = 0; step < FUZZ_STEPS && game_lives(&s_game) > 0; ++step) {
+            // The player moves the paddle between steps.
+            paddle_t *paddle = &s_game.paddle;
+            paddle->x += rng_range(&rng, 7) - 3;
+            paddle->x = paddle->x < 0 ? 0 : paddle->x > SCREEN_W - paddle->w ? SCREEN_W - paddle->w : paddle->x;
+
+            game_t before = s_game;
+            game_step(&s_game);
+            const char *broken = step_broke(&before, &s_game);
+            if (broken) {
+                char message[160];
+                snprintf(message, sizeof(message), "%s: state %ld step %d (FUZZ_SEED=0x%08lx)", broken, n, step,
+                         (unsigned long)seed);
+                TEST_FAIL_MESSAGE(message);
+            }
+        }
+    }
+}
+
+static void test_random_states_keep_the_invariants(void)
+{
+    fuzz(env_or("FUZZ_STATES", FUZZ_STATES), false, NULL);
+}
+
+static void test_random_states_with_powerups_keep_the_invariants(void)
+{
+    fuzz(env_or("FUZZ_STATES", FUZZ_STATES), true, NULL);
+}
+
+static void test_random_obstacle_states_keep_the_invariants(void)
+{
+    fuzz(env_or("FUZZ_STATES", FUZZ_STATES) / 10, false, &s_field);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_reset_serves_from_the_top_centre);
+    RUN_TEST(test_left_wall_reflects_and_clamps);
+    RUN_TEST(test_right_wall_reflects_and_clamps);
+    RUN_TEST(test_top_wall_reflects_and_clamps);
+    RUN_TEST(test_paddle_hit_bounces_the_ball_back_up);
+    RUN_TEST(test_paddle_edges_still_hit);
+    RUN_TEST(test_ball_below_the_paddle_line_is_not_missed_yet);
+    RUN_TEST(test_miss_counts_and_serves_again);
+    RUN_TEST(test_lives_run_out_after_max_lives_misses);
+    RUN_TEST(test_speed_ramps_with_hits);
+    RUN_TEST(test_paddle_hit_takes_the_speed_of_the_new_hit_count);
+    RUN_TEST(test_serve_after_a_miss_is_at_base_speed);
+    RUN_TEST(test_random_states_keep_the_invariants);
+    RUN_TEST(test_random_states_with_powerups_keep_the_invariants);
+    RUN_TEST(test_random_obstacle_states_keep_the_invariants);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+// Grid broadphase against a brute-force scan of every obstacle: the same
+// answers on random fields and boxes, and how much faster the grid is.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "obstacles.h"
+#include "rng.h"
+#include "unity.h"
+
+// The field obstacle Pong plays on.
+#define OBSTACLE_COUNT CONFIG_PONG_OBSTACLE_COUNT
+
+#define RANDOM_FIELDS 2000
+#define QUERIES_PER_FIELD 200
+// Queries timed per benchmark run.
+#define BENCH_QUERIES 1000000
+
+static obstacle_field_t s_field;
+
+void setUp(void)
+{
+    memset(&s_field, 0, sizeof(s_field));
+}
+
+void tearDown(void)
+{
+}
+
+static bool overlaps(rect_t box, const obstacle_t *o)
+{
+    return box.x < o->x + OBSTACLE_W && o->x < box.x + box.w && box.y < o->y + OBSTACLE_H && o->y < box.y + box.h;
+}
+
+// The reference: every obstacle, in order.
+static int hit_brute(const obstacle_field_t *field, rect_t box)
+{
+    for (int i = 0; i < field->count; ++i) {
+        if (overlaps(box, &field->items[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// A ball's swept box for one step, sometimes partly off the field.
+static rect_t random_box(uint32_t *rng)
+{
+    rect_t box = {
+        .x = rng_range(rng, SCREEN_W + 2 * BALL_SIZE) - BALL_SIZE,
+        .y = rng_range(rng, SCREEN_H + 2 * BALL_SIZE) - BALL_SIZE,
+        .w = BALL_SIZE + rng_range(rng, 4),
+        .h = BALL_SIZE + rng_range(rng, 4),
+    };
+    return box;
+}
+
+// The grid may find another obstacle than the scan when several overlap,
+// but never misses one and never reports one that does not overlap.
+static void check_queries(uint32_t *rng, int field_index)
+{
+    for (int q = 0; q < QUERIES_PER_FIELD; ++q) {
+        rect_t box = random_box(rng);
+        int grid = obstacles_hit_grid(&s_field, box);
+        int brute = hit_brute(&s_field, box);
+        char message[96];
+        snprintf(message, sizeof(message), "field %d box %d,%d %dx%d: grid %d, brute force %d", field_index, box.x,
+                 box.y, box.w, box.h, grid, brute);
+        TEST_ASSERT_TRUE_MESSAGE((grid < 0) == (brute < 0), message);
+        if (grid >= 0) {
+            TEST_ASSERT_TRUE_MESSAGE(grid < s_field.count && overlaps(box, &s_field.items[grid]), message);
+        }
+    }
+}
+
+static void test_grid_matches_brute_force(void)
+{
+    uint32_t rng = 0xB0C5u;
+    for (int n = 0; n < RANDOM_FIELDS; ++n) {
+        obstacles_generate(&s_field, 1 + rng_range(&rng, OBSTACLE_MAX), rng_next(&rng));
+        check_queries(&rng, n);
+    }
+}
+
+static void test_grid_stays_current_as_obstacles_move_and_break(void)
+{
+    uint32_t rng = 0x0B57u;
+    for (int n = 0; n < RANDOM_FIELDS / 10; ++n) {
+        obstacles_generate(&s_field, OBSTACLE_MAX, rng_next(&rng));
+        while (s_field.count > 0) {
+            for (int i = rng_range(&rng, 8); i > 0; --i) {
+                obstacles_update(&s_field);
+            }
+            obstacles_damage(&s_field, rng_range(&rng, s_field.count));
+            if (s_field.count % 16 == 0) {
+                check_queries(&rng, n);
+            }
+        }
+        TEST_ASSERT_EQUAL_INT(-1, obstacles_hit_grid(&s_field, (rect_t) { 0, 0, SCREEN_W, SCREEN_H }));
+    }
+}
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static double query_ns(int (*query)(const obstacle_field_t *, rect_t), const rect_t *boxes, int box_count,
+                       int *found)
+{
+    int64_t start = now_ns();
+    for (int i = 0; i < BENCH_QUERIES; ++i) {
+        *found += query(&s_field, boxes[i % box_count]) >= 0;
+    }
+    return (double)(now_ns() - start) / BENCH_QUERIES;
+}
+
+static void test_grid_beats_brute_force(void)
+{
+    static const int counts[] = { 50, OBSTACLE_COUNT, OBSTACLE_MAX };
+    rect_t boxes[1024];
+    uint32_t rng = 0xBE7Cu;
+    for (int i = 0; i < 1024; ++i) {
+        boxes[i] = random_box(&rng);
+    }
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+        obstacles_generate(&s_field, counts[c], 42);
+        int found_grid = 0;
+        int found_brute = 0;
+        double grid_ns = query_ns(obstacles_hit_grid, boxes, 1024, &found_grid);
+        double brute_ns = query_ns(hit_brute, boxes, 1024, &found_brute);
+        char message[96];
+        snprintf(message, sizeof(message), "%d obstacles: grid %.1f ns/query, brute force %.1f ns/query", s_field.count,
+                 grid_ns, brute_ns);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_EQUAL_INT(found_brute, found_grid);
+        if (counts[c] >= OBSTACLE_COUNT) {
+            TEST_ASSERT_TRUE_MESSAGE(grid_ns < brute_ns, message);
+        }
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_grid_matches_brute_force);
+    RUN_TEST(test_grid_stays_current_as_obstacles_move_and_break);
+    RUN_TEST(test_grid_beats_brute_force);
+    return UNITY_END();
+}
@@ -0,0 +1,152 @@
+// Paddle reflection: the outgoing angle per paddle segment, how hits spread
+// across the angles, exact speed after every bounce, and what a hit costs.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "difficulty.h"
+#include "game.h"
+#include "unity.h"
+
+// Same as game.c: the paddle's top edge.
+#define PADDLE_Y (SCREEN_H - PADDLE_H - 2)
+#define PADDLE_X 100
+
+// Steps timed per measurement, and the most a paddle hit may cost on the
+// host; the device budget per step is far larger.
+#define COST_STEPS 1000000
+#define HIT_BUDGET_NS 1000
+
+static game_t s_game;
+
+void setUp(void)
+{
+    difficulty_set_curve(CURVE_LINEAR);
+    memset(&s_game, 0, sizeof(s_game));
+    game_reset(&s_game, 1);
+    s_game.paddle.x = PADDLE_X;
+}
+
+void tearDown(void)
+{
+}
+
+// Drops the ball onto the paddle with its left edge at x pixels and returns
+// the outgoing angle from the vertical in degrees, negative to the left.
+static double hit_at(int x)
+{
+    s_game.ball = (ball_t) { TO_SUBPX(x), TO_SUBPX(PADDLE_Y - BALL_SIZE) - 30, 51, 68 };
+    int hits = s_game.hits;
+    game_step(&s_game);
+    TEST_ASSERT_EQUAL_INT(hits + 1, s_game.hits);
+    TEST_ASSERT_LESS_THAN(0, s_game.ball.vy);
+    return atan2(s_game.ball.vx, -s_game.ball.vy) * 180.0 / M_PI;
+}
+
+static void test_each_segment_sends_the_ball_at_its_angle(void)
+{
+    // Edges send the ball out flat, the centre steeply, mirrored.
+    static const double expected[PADDLE_SEGMENTS] = { -61.9, -53.1, -36.9, -25.1, 25.1, 36.9, 53.1, 61.9 };
+    int w = s_game.paddle.w;
+    for (int s = 0; s < PADDLE_SEGMENTS; ++s) {
+        int centre = PADDLE_X + s * w / PADDLE_SEGMENTS + w / (2 * PADDLE_SEGMENTS);
+        double angle = hit_at(centre - BALL_SIZE / 2);
+        char message[48];
+        snprintf(message, sizeof(message), "segment %d: %.1f deg", s, angle);
+        TEST_ASSERT_TRUE_MESSAGE(fabs(angle - expected[s]) < 0.1, message);
+    }
+}
+
+static void test_angle_distribution_across_the_paddle(void)
+{
+    // Every pixel the ball can touch the paddle at, left to right.
+    int w = s_game.paddle.w;
+    int per_angle[PADDLE_SEGMENTS] = { 0 };
+    double angles[PADDLE_SEGMENTS];
+    int distinct = 0;
+    double last = -90.0;
+    for (int x = PADDLE_X - BALL_SIZE; x <= PADDLE_X + w; ++x) {
+        double angle = hit_at(x);
+        // Moving right never turns the ball further left, and it never
+        // goes straight up.
+        TEST_ASSERT_TRUE(angle >= last - 1e-9);
+        TEST_ASSERT_TRUE(fabs(angle) > 5.0 && fabs(angle) < 65.0);
+        if (distinct == 0 || fabs(angle - angles[distinct - 1]) > 1e-9) {
+            TEST_ASSERT_LESS_THAN(PADDLE_SEGMENTS, distinct);
+            angles[distinct++] = angle;
+        }
+        int centre = x + BALL_SIZE / 2;
+        if (centre >= PADDLE_X && centre < PADDLE_X + w) {
+            per_angle[distinct - 1]++;
+        }
+        last = angle;
+    }
+    TEST_ASSERT_EQUAL_INT(PADDLE_SEGMENTS, distinct);
+    // Segments are equally wide, so each angle owns the same share.
+    for (int s = 0; s < PADDLE_SEGMENTS; ++s) {
+        TEST_ASSERT_INT_WITHIN(1, w / PADDLE_SEGMENTS, per_angle[s]);
+    }
+}
+
+static void test_speed_is_exact_after_every_hit(void)
+{
+    int w = s_game.paddle.w;
+    for (int curve = 0; curve < CURVE_COUNT; ++curve) {
+        difficulty_set_curve((difficulty_curve_t)curve);
+        for (int hits = 0; hits < DIFFICULTY_TABLE_LEN; ++hits) {
+            for (int x = PADDLE_X - BALL_SIZE; x <= PADDLE_X + w; ++x) {
+                s_game.hits = hits;
+                s_game.paddle.w = w;
+                s_game.paddle.x = PADDLE_X;
+                hit_at(x);
+                int v = difficulty_for_hits(hits + 1)->speed * BALL_DIR_ONE;
+                TEST_ASSERT_EQUAL_INT(v * v, s_game.ball.vx * s_game.ball.vx + s_game.ball.vy * s_game.ball.vy);
+            }
+        }
+    }
+}
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Average cost of one step, with the ball put back at y before each.
+static double step_ns(int y)
+{
+    int w = s_game.paddle.w;
+    int64_t start = now_ns();
+    for (int i = 0; i < COST_STEPS; ++i) {
+        int x = PADDLE_X + i % w;
+        s_game.ball = (ball_t) { TO_SUBPX(x), y, 51, 68 };
+        s_game.hits = i & 63;
+        game_step(&s_game);
+    }
+    return (double)(now_ns() - start) / COST_STEPS;
+}
+
+static void test_per_hit_cost(void)
+{
+    double free_ns = step_ns(TO_SUBPX(SCREEN_H / 2));
+    double hit_ns = step_ns(TO_SUBPX(PADDLE_Y - BALL_SIZE) - 30);
+    // The last timed step did hit the paddle.
+    TEST_ASSERT_EQUAL_INT(((COST_STEPS - 1) & 63) + 1, s_game.hits);
+    char message[96];
+    snprintf(message, sizeof(message), "step %.1f ns in free flight, %.1f ns with a paddle hit", free_ns, hit_ns);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(hit_ns < HIT_BUDGET_NS, message);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_each_segment_sends_the_ball_at_its_angle);
+    RUN_TEST(test_angle_distribution_across_the_paddle);
+    RUN_TEST(test_speed_is_exact_after_every_hit);
+    RUN_TEST(test_per_hit_cost);
+    return UNITY_END();
+}
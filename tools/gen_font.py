@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Generate the proportional font tables from the 8x8 source font.
+
+Usage: gen_font.py <font8x8_basic.h> <font_prop.c>
+
+Every printable ASCII glyph is trimmed to its inked rows and columns. The
+generator then stores:
+
+  * the packed rows, one byte each, MSB = first inked column;
+  * per glyph: advance, left/top bearing, width and row count;
+  * a kerning table for pairs of letters, digits and common punctuation
+    whose facing edges leave at least KERN_MIN pixels more than the usual
+    one pixel of space. It is grouped by the first character, so a lookup
+    scans only the few pairs starting with that character.
+
+The output only depends on the input, so rebuilding leaves it unchanged.
+"""
+
+import re
+import string
+import sys
+
+FIRST = 0x20
+LAST = 0x7E
+CELL = 8
+SPACING = 1         # empty columns between two glyphs
+SPACE_ADVANCE = 4
+NARROW = 2          # glyphs this narrow get a column of bearing each side
+KERN_MIN = 2        # smaller gains are not worth a table entry
+KERN_MAX = 3        # pixels at scale 1
+KERN_CHARS = set(string.ascii_letters + string.digits + ".,:'-")
+
+
+def load_font(path):
+    with open(path, encoding="ascii") as f:
+        text = f.read()
+    rows = re.findall(r"\{\s*((?:0x[0-9A-Fa-f]{2}\s*,?\s*){8})\}", text)
+    if len(rows) != 128:
+        sys.exit(f"{path}: expected 128 glyphs, found {len(rows)}")
+    return [[int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]{2}", r)] for r in rows]
+
+
+def columns(bits):
+    return [c for c in range(CELL) if bits & (0x80 >> c)]
+
+
+def make_glyph(bitmap):
+    inked = [r for r in range(CELL) if bitmap[r]]
+    if not inked:
+        return {"rows": [], "left": 0, "top": 0, "width": 0, "advance": SPACE_ADVANCE, "edges": {}}
+    top, bottom = inked[0], inked[-1]
+    first = min(columns(bitmap[r])[0] for r in inked)
+    last = max(columns(bitmap[r])[-1] for r in inked)
+    width = last - first + 1
+    left = 1 if width <= NARROW else 0
+    rows = [(bitmap[r] << first) & 0xFF for r in range(top, bottom + 1)]
+    # Leftmost and rightmost inked column per cell row, in pen coordinates.
+    edges = {}
+    for r in inked:
+        cols = columns(bitmap[r])
+        edges[r] = (left + cols[0] - first, left + cols[-1] - first)
+    return {
+        "rows": rows,
+        "left": left,
+        "top": top,
+        "width": width,
+        "advance": left + width + left + SPACING,
+        "edges": edges,
+    }
+
+
+def kerning(a, b):
+    """Pixels the pair can move closer while keeping one clear column
+    against every inked row of `b` within one row of `a`."""
+    gaps = []
+    for r, (_, right) in a["edges"].items():
+        for rb in (r - 1, r, r + 1):
+            if rb in b["edges"]:
+                gaps.append(a["advance"] + b["edges"][rb][0] - right - 1)
+    if not gaps:
+        return 0
+    return -min(min(gaps) - SPACING, KERN_MAX)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    font = load_font(sys.argv[1])
+    glyphs = [make_glyph(font[c]) for c in range(FIRST, LAST + 1)]
+
+    bitmap = []
+    entries = []
+    for g in glyphs:
+        entries.append((len(bitmap), g))
+        bitmap.extend(g["rows"])
+
+    kern_index = [0]
+    kern_pairs = []
+    for i, a in enumerate(glyphs):
+        for j, b in enumerate(glyphs):
+            if chr(FIRST + i) in KERN_CHARS and chr(FIRST + j) in KERN_CHARS:
+                adjust = kerning(a, b)
+                if adjust <= -KERN_MIN:
+                    kern_pairs.append((FIRST + j, adjust, FIRST + i))
+        kern_index.append(len(kern_pairs))
+
+    out = []
+    out.append("// Generated by tools/gen_font.py from font8x8_basic.h. Do not edit.")
+    out.append("")
+    out.append('#include "font_prop.h"')
+    out.append("")
+    out.append("const font_glyph_t g_font_prop_glyphs[FONT_PROP_COUNT] = {")
+    for c, (offset, g) in zip(range(FIRST, LAST + 1), entries):
+        out.append(f"    {{ {offset:4d}, {g['advance']}, {g['left']}, {g['top']}, {g['width']}, {len(g['rows'])} }}, // {chr(c)!r}")
+    out.append("};")
+    out.append("")
+    out.append(f"const uint8_t g_font_prop_bitmaps[{max(len(bitmap), 1)}] = {{")
+    for i in range(0, len(bitmap), 12):
+        out.append("    " + ", ".join(f"0x{v:02X}" for v in bitmap[i:i + 12]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("const uint16_t g_font_prop_kern_index[FONT_PROP_COUNT + 1] = {")
+    for i in range(0, len(kern_index), 12):
+        out.append("    " + ", ".join(str(v) for v in kern_index[i:i + 12]) + ",")
+    out.append("};")
+    out.append("")
+    out.append(f"const font_kern_t g_font_prop_kern[{max(len(kern_pairs), 1)}] = {{")
+    for second, adjust, first in kern_pairs:
+        out.append(f"    {{ {second}, {adjust} }}, // {chr(first) + chr(second)!r}")
+    if not kern_pairs:
+        out.append("    { 0, 0 },")
+    out.append("};")
+    out.append("")
+
+    with open(sys.argv[2], "w", encoding="ascii", newline="\n") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
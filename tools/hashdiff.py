@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Compare the game state hashes of two runs and report where they diverge.
+
+Usage: hashdiff.py <log_a> <log_b>
+
+Reads the "hash:" lines logged with CONFIG_PONG_STATE_HASH from two serial
+or host logs. Games are paired in the order they were played. For each
+pair, the first logged step with a different rolling hash is reported,
+along with the last step that still matched. A divergence in the input hash
+means the runs were not given the same input, so a state difference from
+there on says nothing about the simulation. Exits with status 1 when any
+pair diverges.
+"""
+
+import re
+import sys
+
+SEED_RE = re.compile(r"hash: (\S+) seed ([0-9a-fA-F]+)")
+TICK_RE = re.compile(r"hash: (\S+) tick (\d+) state ([0-9a-fA-F]+) input ([0-9a-fA-F]+)")
+
+
+class Run:
+    def __init__(self, game, seed):
+        self.game = game
+        self.seed = seed
+        # tick -> (state hash, input hash)
+        self.ticks = {}
+        self.last_tick = 0
+
+
+def read_runs(path):
+    runs = []
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            m = SEED_RE.search(line)
+            if m:
+                runs.append(Run(m.group(1), int(m.group(2), 16)))
+                continue
+            m = TICK_RE.search(line)
+            if m and runs and runs[-1].game == m.group(1):
+                tick = int(m.group(2))
+                runs[-1].ticks[tick] = (int(m.group(3), 16), int(m.group(4), 16))
+                runs[-1].last_tick = max(runs[-1].last_tick, tick)
+    return runs
+
+
+def compare(index, a, b):
+    """Prints the result for one pair of runs; returns True if they match."""
+    label = f"game {index + 1} ({a.game})"
+    if a.game != b.game:
+        print(f"{label}: the other log played {b.game}")
+        return False
+    if a.seed != b.seed:
+        print(f"{label}: seeds differ ({a.seed:08x} vs {b.seed:08x}), runs are not comparable")
+        return False
+
+    matched = 0
+    for tick in sorted(a.ticks.keys() & b.ticks.keys()):
+        state_a, input_a = a.ticks[tick]
+        state_b, input_b = b.ticks[tick]
+        if input_a != input_b:
+            print(f"{label}: input diverges after step {matched}, by step {tick}; "
+                  f"the runs were not given the same input")
+            return False
+        if state_a != state_b:
+            print(f"{label}: state diverges after step {matched}, by step {tick}")
+            if tick - matched > 1:
+                print("  log every step (CONFIG_PONG_STATE_HASH_EVERY=1) to find the exact one")
+            return False
+        matched = tick
+
+    if a.last_tick != b.last_tick:
+        print(f"{label}: identical up to step {matched}, then one run ended "
+              f"(step {a.last_tick} vs {b.last_tick})")
+        return False
+    print(f"{label}: identical over {matched} steps")
+    return True
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    runs_a = read_runs(sys.argv[1])
+    runs_b = read_runs(sys.argv[2])
+    if not runs_a or not runs_b:
+        sys.exit("error: no state hashes found (build with CONFIG_PONG_STATE_HASH)")
+
+    ok = True
+    for index, (a, b) in enumerate(zip(runs_a, runs_b)):
+        ok = compare(index, a, b) and ok
+    if len(runs_a) != len(runs_b):
+        print(f"the logs hold {len(runs_a)} and {len(runs_b)} games; compared the first {min(len(runs_a), len(runs_b))}")
+        ok = False
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
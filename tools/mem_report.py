@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""Report static RAM per subsystem from the linker map and enforce a budget.
+
+Usage: mem_report.py <project.map> <budget_kib>
+
+Every input section of the main component that lands in RAM (.data, .bss,
+COMMON, .dram1 and friends) is charged to the source file it came from; a
+source file is a subsystem. Other components are listed as one line for
+reference and do not count against the budget. Exits with status 1 when the
+main component needs more than the budget.
+"""
+
+import collections
+import re
+import sys
+
+RAM_SECTIONS = (".data", ".sdata", ".bss", ".sbss", "COMMON", ".dram1", ".noinit")
+MAIN_LIB = "libmain.a("
+
+NAME_RE = re.compile(r"^ ([.\w][^\s]*)$")
+ENTRY_RE = re.compile(r"^ ([.\w][^\s]*)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+
+def input_sections(path):
+    """Yields (section, address, size, object) for every input section in
+    the memory map part of a GNU ld map file."""
+    in_map = False
+    pending = None
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not in_map:
+                in_map = line.startswith("Linker script and memory map")
+                continue
+            m = NAME_RE.match(line)
+            if m:
+                pending = m.group(1)
+                continue
+            m = ENTRY_RE.match(line)
+            if m:
+                name = m.group(1) or pending
+                pending = None
+                if name:
+                    yield name, int(m.group(2), 16), int(m.group(3), 16), m.group(4).strip()
+                continue
+            pending = None
+
+
+def subsystem(obj):
+    """'esp-idf/main/libmain.a(display.c.obj)' -> 'display'."""
+    name = obj[obj.index(MAIN_LIB) + len(MAIN_LIB):].rstrip(")")
+    for suffix in (".obj", ".o", ".cpp", ".c"):
+        if name.endswith(suffix):
+            name = name[: -len(suffix)]
+    return name
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    budget = int(sys.argv[2]) * 1024
+
+    usage = collections.defaultdict(lambda: [0, 0])
+    other = 0
+    for name, address, size, obj in input_sections(sys.argv[1]):
+        if address == 0 or size == 0 or not name.startswith(RAM_SECTIONS):
+            continue
+        zeroed = name.startswith((".bss", ".sbss", "COMMON"))
+        if MAIN_LIB in obj:
+            usage[subsystem(obj)][1 if zeroed else 0] += size
+        else:
+            other += size
+
+    total = sum(data + bss for data, bss in usage.values())
+    print(f"Static RAM of the main component (budget {budget // 1024} KiB):")
+    print(f"  {'subsystem':<16} {'data':>8} {'bss':>8} {'total':>8}")
+    for name, (data, bss) in sorted(usage.items(), key=lambda item: -sum(item[1])):
+        print(f"  {name:<16} {data:>8} {bss:>8} {data + bss:>8}")
+    print(f"  {'total':<16} {'':>8} {'':>8} {total:>8}  ({total / 1024:.1f} KiB)")
+    print(f"  {'other components':<16} {'':>8} {'':>8} {other:>8}  (not budgeted)")
+
+    if total > budget:
+        print(f"error: static RAM {total / 1024:.1f} KiB exceeds the {budget // 1024} KiB budget "
+              f"(CONFIG_PONG_RAM_BUDGET_KB)", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())